@@ -4,13 +4,9 @@
 
 Response AuthController::showLogin(Request& request) {
 		// Check if user is already authenticated
-		String token = request.header("Authorization");
-		if (token.length() > 0 && token.startsWith("Bearer ")) {
-				String authToken = token.substring(7);
-				if (verifyToken(authToken)) {
-						return Response(request.getServerRequest())
-								.redirect("/dashboard");
-				}
+		if (request.auth()) {
+				return Response(request.getServerRequest())
+						.redirect("/dashboard");
 		}
 		
 		// Serve login page from SPIFFS
@@ -50,7 +46,6 @@ Response AuthController::login(Request& request) {
 		}
 		
 		// Validate credentials
-		User* user = nullptr;
 		if (!validateCredentials(username, password)) {
 				JsonDocument error;
 				error["success"] = false;
@@ -62,21 +57,28 @@ Response AuthController::login(Request& request) {
 		}
 		
 		// Get user data from database
-		user = User::findByUsername(username);
+		User* user = User::findByUsername(username);
+		if (user == nullptr) {
+				JsonDocument error;
+				error["success"] = false;
+				error["message"] = "Invalid username or password";
+				
+				return Response(request.getServerRequest())
+						.status(401)
+						.json(error);
+		}
 		
-		// Generate JWT token
-		String token = generateToken(username);
+		// Sign id, role and expiry so later requests need no lookup
+		String token = generateToken(*user);
 		
 		JsonDocument response;
 		response["success"] = true;
 		response["message"] = "Login successful";
 		response["token"] = token;
 		response["redirect"] = redirect;
-		response["user"]["username"] = user ? user->getUsername() : username;
+		response["user"]["username"] = user->getUsername();
 		
-		if (user) {
-				delete user;
-		}
+		delete user;
 		
 		return Response(request.getServerRequest())
 				.json(response);
@@ -134,78 +136,68 @@ bool AuthController::validateCredentials(const String& username, const String& p
 		return isValid;
 }
 
-String AuthController::generateToken(const String& username) {
-		// Simple token generation - in production use proper JWT library
-		// For demo, encode username in the token for easy extraction
-		String token = "cozmo_token_" + username + "_" + String(millis());
-		// In real implementation, use proper JWT encoding with signature
-		return token;
+String AuthController::generateToken(const User& user) {
+		return AuthToken::issue(user.getId(), user.getRole());
 }
 
-bool AuthController::verifyToken(const String& token) {
-		// Simple token verification - in production use proper JWT verification
-		return token.startsWith("cozmo_token_") && token.length() > 20;
-}
+// Small LRU of users looked up by getCurrentUser()
+struct CachedUser {
+		uint32_t id = 0;
+		std::shared_ptr<User> user;
+		unsigned long loadedAt = 0;
+		unsigned long lastUsed = 0;
+};
 
-String AuthController::extractUsernameFromToken(const String& token) {
-		// Simple username extraction - in production parse JWT payload
-		if (token.indexOf("cozmo_token_") == 0) {
-				// Extract username from token format: cozmo_token_username_timestamp
-				int firstUnderscore = token.indexOf('_', 11); // After "cozmo_token_"
-				int lastUnderscore = token.lastIndexOf('_');
-				
-				if (firstUnderscore != -1 && lastUnderscore != -1 && firstUnderscore != lastUnderscore) {
-						String username = token.substring(11, lastUnderscore); // Extract username part\
-						return username;
-				}
-		}
-		return "";
-}
+static CachedUser userCache[AUTH_USER_CACHE_SIZE];
 
 // Static helper methods for other controllers
 String AuthController::getCurrentUserUsername(Request& request) {
-		String token = request.header("Authorization");
-		
-		if (token.length() == 0) {
-				return "";
-		}
-		
-		if (token.startsWith("Bearer ")) {
-				token = token.substring(7);
-		}
-		
-		// Simple token verification - in production use proper JWT
-		if (!token.startsWith("cozmo_token_")) {
-				return "";
+		std::shared_ptr<User> user = getCurrentUser(request);
+		return user ? user->getUsername() : "";
+}
+
+std::shared_ptr<User> AuthController::getCurrentUser(Request& request) {
+		const TokenClaims* claims = request.auth();
+		if (claims == nullptr) {
+				return nullptr;
 		}
 		
-		// Extract username from token format: cozmo_token_username_timestamp
-		int tokenPrefix = String("cozmo_token_").length();
-		int lastUnderscore = token.lastIndexOf('_');
-		
-		if (lastUnderscore != -1) {
-				String username = token.substring(tokenPrefix, lastUnderscore); // Extract username part
-				return username;
+		unsigned long now = millis();
+		CachedUser* slot = &userCache[0];
+		for (CachedUser& entry : userCache) {
+				if (entry.user && entry.id == claims->userId) {
+						if (now - entry.loadedAt < AUTH_USER_CACHE_TTL) {
+								entry.lastUsed = now;
+								return entry.user;
+						}
+						slot = &entry;
+						break;
+				}
+				// Prefer an empty slot, then the least recently used one
+				if (slot->user && (!entry.user || now - entry.lastUsed > now - slot->lastUsed)) {
+						slot = &entry;
+				}
 		}
 		
-		return "";
-}
-
-User* AuthController::getCurrentUser(Request& request) {
-		String username = getCurrentUserUsername(request);
-
-		if (username.length() == 0) {
+		User* user = User::findById(claims->userId);
+		if (user == nullptr) {
+				slot->user.reset();
 				return nullptr;
 		}
 		
-		User* user = User::findByUsername(username);
-		return user;
+		// Handlers holding the previous record keep it alive through their shared_ptr
+		slot->id = claims->userId;
+		slot->user = std::shared_ptr<User>(user);
+		slot->loadedAt = now;
+		slot->lastUsed = now;
+		return slot->user;
 }
 
 Response AuthController::getUserInfo(Request& request) {
 	// Use the same authentication logic as other methods
-	User* user = getCurrentUser(request);
-	if (user == nullptr) {
+	const TokenClaims* claims = request.auth();
+	std::shared_ptr<User> user = getCurrentUser(request);
+	if (claims == nullptr || user == nullptr) {
 		JsonDocument error;
 		error["success"] = false;
 		error["message"] = "Authentication required or user not found";
@@ -220,13 +212,11 @@ Response AuthController::getUserInfo(Request& request) {
 	response["success"] = true;
 	response["user"]["username"] = user->getUsername();
 	
-	// For demo purposes, check if username is admin
-	bool isAdmin = (user->getUsername() == "admin");
+	// Permissions follow the role signed into the token
+	bool isAdmin = (claims->role == "admin");
 	response["user"]["permissions"]["canManageUsers"] = isAdmin;
 	response["user"]["permissions"]["canRestartSystem"] = isAdmin;
-	response["user"]["role"] = isAdmin ? "admin" : "user";
-	
-	delete user;
+	response["user"]["role"] = claims->role;
 	
 	return Response(request.getServerRequest())
 		.json(response);
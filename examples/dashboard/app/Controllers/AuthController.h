@@ -2,6 +2,19 @@
 #define AUTH_CONTROLLER_H
 
 #include <MVCFramework.h>
+#include <memory>
+
+class User;
+
+// Users kept by getCurrentUser() so repeated requests skip the CSV lookup
+#ifndef AUTH_USER_CACHE_SIZE
+#define AUTH_USER_CACHE_SIZE 4
+#endif
+
+// Cached users are reloaded after this long so changes reach active sessions
+#ifndef AUTH_USER_CACHE_TTL
+#define AUTH_USER_CACHE_TTL 60000
+#endif
 
 class AuthController : public Controller {
 public:
@@ -17,18 +30,16 @@ public:
     // GET /dashboard - Show dashboard (requires auth)
     Response dashboard(Request& request);
     
-    // Static helper methods for other controllers
+    // Static helper methods for other controllers; role checks should use request.auth() instead
     static String getCurrentUserUsername(Request& request);
-    static class User* getCurrentUser(Request& request);
+    static std::shared_ptr<User> getCurrentUser(Request& request);
     
     // API method for getting current user info
     Response getUserInfo(Request& request);
     
 private:
     bool validateCredentials(const String& username, const String& password);
-    String generateToken(const String& username);
-    bool verifyToken(const String& token);
-    String extractUsernameFromToken(const String& token);
+    String generateToken(const User& user);
 };
 
 #endif
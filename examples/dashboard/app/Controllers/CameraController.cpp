@@ -3,9 +3,6 @@
 // Static member initialization
 bool CameraController::cameraEnabled = true; // Enable camera by default
 
-// Camera buffer
-camera_fb_t* frame = nullptr;
-
 Response CameraController::getSettings(Request& request) {
     JsonDocument response;
     response["success"] = true;
@@ -66,6 +63,7 @@ Response CameraController::updateSettings(Request& request) {
         response["success"] = true;
         response["message"] = "Camera settings updated successfully";
         response["settings"] = getCurrentSettings();
+        ResponseCache::getInstance()->invalidate("/api/v1/camera/settings");
     } else {
         response["success"] = false;
         response["message"] = "Failed to apply camera settings";
@@ -90,17 +88,18 @@ Response CameraController::capture(Request& request) {
     }
     
     // Capture frame
-    camera.release(frame);
-    frame = camera.capture();
-    
-    if (frame->buf && frame->len > 0) {
-        // Send binary JPEG data directly using AsyncWebServerRequest
-        AsyncWebServerRequest* serverRequest = request.getServerRequest();
-				Response result = Response(serverRequest)
-						.status(200)
-						.binary((const uint8_t*)frame->buf, frame->len, "image/jpeg");
-        return result;
+    camera_fb_t* frame = camera.capture();
+    
+    if (frame && frame->buf && frame->len > 0) {
+        // Send the frame buffer in place and hand it back to the driver once it is sent
+        return Response(request.getServerRequest())
+            .status(200)
+            .binary((const uint8_t*)frame->buf, frame->len, "image/jpeg", [frame]() {
+                Camera::getInstance().release(frame);
+            });
     } else {
+        camera.release(frame);
+        
         JsonDocument response;
         response["success"] = false;
         response["message"] = "Failed to capture image";
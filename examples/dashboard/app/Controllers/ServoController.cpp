@@ -22,7 +22,7 @@ Response ServoController::getServos(Request& request) {
     
     return Response(request.getServerRequest())
         .status(200)
-        .json(response);
+        .json(std::move(response));
 }
 
 Response ServoController::addServo(Request& request) {
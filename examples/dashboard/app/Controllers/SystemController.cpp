@@ -9,7 +9,7 @@ Response SystemController::getStats(Request& request) {
     
     return Response(request.getServerRequest())
         .status(200)
-        .json(response);
+        .json(std::move(response));
 }
 
 Response SystemController::restart(Request& request) {
@@ -146,6 +146,39 @@ JsonDocument SystemController::getSystemInfo() {
     
     systemInfo["software"] = software;
     
+    // Response cache effectiveness
+    ResponseCache* cache = ResponseCache::getInstance();
+    JsonDocument responseCache;
+    responseCache["entries"] = cache->getEntryCount();
+    responseCache["bytes"] = cache->getBytes();
+    responseCache["hits"] = cache->getHits();
+    responseCache["misses"] = cache->getMisses();
+    responseCache["evictions"] = cache->getEvictions();
+    responseCache["hit_ratio"] = cache->getHitRatio();
+    
+    systemInfo["response_cache"] = responseCache;
+    
+    // Requests that shared another request's handler run
+    Router* router = Application::getInstance()->getRouter();
+    if (router) {
+        JsonDocument coalescing;
+        coalescing["executions"] = router->getCoalesceExecutions();
+        coalescing["coalesced"] = router->getCoalescedRequests();
+        systemInfo["coalescing"] = coalescing;
+        
+        // Requests refused by the admission middleware
+        AdmissionControlMiddleware* admission = static_cast<AdmissionControlMiddleware*>(router->getMiddleware("admission"));
+        if (admission) {
+            JsonDocument load;
+            load["in_flight"] = admission->getInFlight();
+            load["peak_in_flight"] = admission->getPeakInFlight();
+            load["admitted"] = admission->getAdmitted();
+            load["shed_load"] = admission->getShedForLoad();
+            load["shed_heap"] = admission->getShedForHeap();
+            systemInfo["admission"] = load;
+        }
+    }
+    
     return systemInfo;
 }
 
@@ -216,7 +249,7 @@ Response SystemController::getConfigurations(Request& request) {
         response["message"] = "Configuration database not initialized";
         return Response(request.getServerRequest())
             .status(500)
-            .json(response);
+            .json(std::move(response));
     }
     
     std::vector<std::map<String, String>> results = db->select("configurations");
@@ -238,7 +271,7 @@ Response SystemController::getConfigurations(Request& request) {
     response["success"] = true;
     return Response(request.getServerRequest())
         .status(200)
-        .json(response);
+        .json(std::move(response));
 }
 
 Response SystemController::updateConfiguration(Request& request) {
@@ -263,6 +296,7 @@ Response SystemController::updateConfiguration(Request& request) {
     
     // Store the configuration
     if (Configuration::set(key, value)) {
+        ResponseCache::getInstance()->invalidate("/api/v1/system/configurations");
         response["success"] = true;
         response["message"] = "Configuration updated successfully";
         response["key"] = key;
@@ -321,6 +355,7 @@ Response SystemController::updateHostname(Request& request) {
     
     // Update current hostname
     WiFi.setHostname(newHostname.c_str());
+    ResponseCache::getInstance()->invalidatePrefix("/api/v1/system/");
     
     // Update mDNS
     MDNS.end();
@@ -0,0 +1,18 @@
+#include "AdminMiddleware.h"
+
+Response AdminMiddleware::handle(Request& request, MiddlewareChain& next) {
+    // The role is part of the signed token, so no user lookup is needed
+    const TokenClaims* claims = request.auth();
+    
+    if (claims == nullptr || claims->role != "admin") {
+        JsonDocument error;
+        error["success"] = false;
+        error["message"] = "Administrator access required";
+        
+        return Response(request.getServerRequest())
+            .status(403)
+            .json(error);
+    }
+    
+    return next(request);
+}
@@ -0,0 +1,12 @@
+#ifndef ADMIN_MIDDLEWARE_H
+#define ADMIN_MIDDLEWARE_H
+
+#include <MVCFramework.h>
+
+// Allows the request through only for the admin user; must run after "auth"
+class AdminMiddleware : public Middleware {
+public:
+    Response handle(Request& request, MiddlewareChain& next) override;
+};
+
+#endif
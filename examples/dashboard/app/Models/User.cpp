@@ -1,5 +1,4 @@
 #include "User.h"
-#include <Crypto.h>
 
 bool User::authenticate(const String& password) const {
     // Simple password check (in production, use proper hashing)
@@ -12,14 +11,16 @@ void User::hashPassword(const String& password) {
     setPassword(password);
 }
 
-User* User::findByUsername(const String& username) {
-    if (!database) {
-        return nullptr;
+String User::getRole() const {
+    // Databases created before the role column treat the admin account as the only administrator
+    String role = get("role");
+    if (role.length() > 0) {
+        return role;
     }
-    
-    std::map<String, String> where;
-    where["username"] = username;
-    
+    return getUsername() == "admin" ? "admin" : "user";
+}
+
+User* User::findFirst(const std::map<String, String>& where) {
     auto record = database->findWhere("users", where);
     if (record.empty()) {
         return nullptr;
@@ -33,6 +34,26 @@ User* User::findByUsername(const String& username) {
     return user;
 }
 
+User* User::findByUsername(const String& username) {
+    if (!database) {
+        return nullptr;
+    }
+    
+    std::map<String, String> where;
+    where["username"] = username;
+    return findFirst(where);
+}
+
+User* User::findById(uint32_t id) {
+    if (!database) {
+        return nullptr;
+    }
+    
+    std::map<String, String> where;
+    where["id"] = String(id);
+    return findFirst(where);
+}
+
 std::vector<User*> User::all() {
     if (!database) {
         return std::vector<User*>();
@@ -16,12 +16,16 @@ public:
     String getPassword() const { return get("password"); }
     void setPassword(const String& password) { set("password", password); }
     
+    uint32_t getId() const { return get("id").toInt(); }
+    String getRole() const;
+    
     // Methods
     bool authenticate(const String& password) const;
     void hashPassword(const String& password);
     
     // Static methods
     static User* findByUsername(const String& username);
+    static User* findById(uint32_t id);
     static std::vector<User*> all();
     
     // Validation
@@ -30,6 +34,8 @@ public:
     
 protected:
     void touch() override;
+    
+    static User* findFirst(const std::map<String, String>& where);
 };
 
 #endif
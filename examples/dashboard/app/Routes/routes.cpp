@@ -4,9 +4,31 @@
 #include "../Controllers/ServoController.h"
 #include <SPIFFS.h>
 
+// Generated by scripts/embed_assets.py before each PlatformIO build
+#if __has_include("../Generated/EmbeddedAssets.h")
+#include "../Generated/EmbeddedAssets.h"
+#define HAS_EMBEDDED_ASSETS
+#endif
+
 void registerWebRoutes(Router* router) {
 		AuthController* authController = new AuthController();
+		
+		// Files served from SPIFFS keep their names, so browsers revalidate with the ETag
+		StaticFileCache::getInstance()->setCachePolicy("/assets/", "public, max-age=300");
+		StaticFileCache::getInstance()->setCachePolicy("/views/", "no-cache");
 
+#ifdef HAS_EMBEDDED_ASSETS
+		// Fingerprinted assets and the app view are compiled into the firmware
+		router->assets(embeddedAssets, embeddedAssetCount);
+		
+		const EmbeddedAsset* appView = findEmbeddedAsset(embeddedAssets, embeddedAssetCount, "/views/app.html");
+		if (appView) {
+				router->get("/", [appView](Request& request) -> Response {
+						return Response(request.getServerRequest())
+								.asset(*appView);
+				}).name("app");
+		}
+#else
 		// Single-page application route
 		router->get("/", [](Request& request) -> Response {
 				// Serve the app.html as the main entry point
@@ -19,6 +41,7 @@ void registerWebRoutes(Router* router) {
 				return Response(request.getServerRequest())
 						.status(404);
 		}).name("app");
+#endif
 		
 		// Authentication routes
 		router->get("/login", [](Request& request) -> Response {
@@ -61,7 +84,7 @@ void registerWebRoutes(Router* router) {
 void registerApiRoutes(Router* router) {
 		// API routes with middleware
 		router->group("/api/v1", [&](Router& api) {
-				api.middleware({"cors", "json", "ratelimit"});
+				api.middleware({"admission", "cors", "json", "ratelimit"}); // Shed load first, before any work is done
 				
 				// Auth routes for user info (register first to avoid conflicts)
 				api.group("/auth", [&](Router& auth) {
@@ -69,7 +92,7 @@ void registerApiRoutes(Router* router) {
 						
 						auth.get("/user", [authController](Request& request) -> Response {
 								return authController->getUserInfo(request);
-						}).name("api.auth.user");
+						}).name("api.auth.user").critical();
 						
 						auth.post("/password", [authController](Request& request) -> Response {
 								// Password update endpoint (not implemented yet)
@@ -80,7 +103,7 @@ void registerApiRoutes(Router* router) {
 								return Response(request.getServerRequest())
 										.status(200)
 										.json(response);
-						}).name("api.auth.password");
+						}).name("api.auth.password").critical();
 				});
 				
 				// Admin routes
@@ -116,16 +139,16 @@ void registerApiRoutes(Router* router) {
 						// Camera settings
 						camera.get("/settings", [](Request& request) -> Response {
 								return CameraController::getSettings(request);
-						}).name("api.camera.settings.get");
+						}).name("api.camera.settings.get").cache(30000);
 						
 						camera.post("/settings", [](Request& request) -> Response {
 								return CameraController::updateSettings(request);
 						}).name("api.camera.settings.update");
 						
 						// Camera capture
-						camera.post("/capture", [](Request& request) -> Response {
+						camera.get("/capture", [](Request& request) -> Response {
 								return CameraController::capture(request);
-						}).name("api.camera.capture");
+						}).name("api.camera.capture").coalesce();
 						
 						// Camera status and control
 						camera.get("/status", [](Request& request) -> Response {
@@ -148,7 +171,7 @@ void registerApiRoutes(Router* router) {
 						// Get system statistics
 						system.get("/stats", [](Request& request) -> Response {
 								return SystemController::getStats(request);
-						}).name("api.system.stats");
+						}).name("api.system.stats").coalesce(500);
 						
 						// Get detailed memory information
 						system.get("/memory", [](Request& request) -> Response {
@@ -158,7 +181,7 @@ void registerApiRoutes(Router* router) {
 						// Get network information
 						system.get("/network", [](Request& request) -> Response {
 								return SystemController::getNetworkInfo(request);
-						}).name("api.system.network");
+						}).name("api.system.network").cache(10000);
 						
 						// Get hostname information
 						system.get("/hostname", [](Request& request) -> Response {
@@ -173,7 +196,7 @@ void registerApiRoutes(Router* router) {
 						// Get all configurations
 						system.get("/configurations", [](Request& request) -> Response {
 								return SystemController::getConfigurations(request);
-						}).name("api.system.configs.get");
+						}).name("api.system.configs.get").cache(30000);
 						
 						// Update a configuration
 						system.post("/configuration", [](Request& request) -> Response {
@@ -183,7 +206,7 @@ void registerApiRoutes(Router* router) {
 						// System restart (admin only)
 						system.post("/restart", [](Request& request) -> Response {
 								return SystemController::restart(request);
-						}).name("api.system.restart");
+						}).name("api.system.restart").critical();
 				});
 
 				// Servo routes
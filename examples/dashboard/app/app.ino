@@ -2,6 +2,7 @@
 #include "app.h"
 #include "Models/Configuration.h"
 #include "Models/ServoConfig.h"
+#include "Middleware/AdminMiddleware.h"
 
 Application* app;
 CsvDatabase* database;
@@ -69,6 +70,7 @@ void setup() {
     
     // Register routes
     Router* router = app->getRouter();
+    router->registerMiddleware("admin", std::make_shared<AdminMiddleware>());
     registerWebSocketRoutes(router);
     registerWebRoutes(router);
     registerApiRoutes(router);
@@ -959,10 +959,8 @@ document.addEventListener('DOMContentLoaded', function() {
 		function capturePhoto() {
 				// Single capture via HTTP API
 				fetch('/api/v1/camera/capture', {
-						method: 'POST',
 						headers: {
-								'Authorization': `Bearer ${APP_STATE.auth.token}`,
-								'Content-Type': 'application/x-www-form-urlencoded'
+								'Authorization': `Bearer ${APP_STATE.auth.token}`
 						}
 				})
 				.then(response => {
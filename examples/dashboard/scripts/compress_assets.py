@@ -0,0 +1,74 @@
+"""
+Pre-compress static assets so Response::file() can serve .gz sidecars.
+
+Runs automatically before the filesystem image is built (pio run -t buildfs /
+uploadfs), or by hand:
+
+    python3 scripts/compress_assets.py [data_dir]
+"""
+import gzip
+import os
+import sys
+
+# Directories under data/ holding static files; database CSVs are left alone
+ASSET_DIRS = ("assets", "views")
+EXTENSIONS = (".html", ".htm", ".css", ".js", ".json", ".svg", ".txt", ".ico")
+
+
+def compress_file(source, target):
+    with open(source, "rb") as f:
+        raw = f.read()
+    # mtime=0 keeps the output stable between builds
+    packed = gzip.compress(raw, compresslevel=9, mtime=0)
+    with open(target, "wb") as f:
+        f.write(packed)
+    return len(raw), len(packed)
+
+
+def compress_assets(data_dir):
+    total_raw = 0
+    total_packed = 0
+
+    print("Compressing static assets in %s" % data_dir)
+    for asset_dir in ASSET_DIRS:
+        root_dir = os.path.join(data_dir, asset_dir)
+        for root, _, files in os.walk(root_dir):
+            for name in sorted(files):
+                if not name.lower().endswith(EXTENSIONS):
+                    continue
+
+                source = os.path.join(root, name)
+                target = source + ".gz"
+                if os.path.exists(target) and os.path.getmtime(target) >= os.path.getmtime(source):
+                    raw, packed = os.path.getsize(source), os.path.getsize(target)
+                else:
+                    raw, packed = compress_file(source, target)
+
+                # A sidecar that does not save space only costs flash
+                if packed >= raw:
+                    os.remove(target)
+                    packed = raw
+
+                total_raw += raw
+                total_packed += packed
+                saved = raw - packed
+                print("  %-40s %8d -> %8d bytes (saved %d, %.1f%%)" % (
+                    os.path.relpath(source, data_dir), raw, packed, saved,
+                    100.0 * saved / raw if raw else 0))
+
+    saved = total_raw - total_packed
+    print("  %-40s %8d -> %8d bytes (saved %d, %.1f%%)" % (
+        "total", total_raw, total_packed, saved,
+        100.0 * saved / total_raw if total_raw else 0))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+
+    def before_buildfs(source, target, env):
+        compress_assets(env.subst("$PROJECT_DATA_DIR"))
+
+    env.AddPreAction("$BUILD_DIR/${ESP32_FS_IMAGE_NAME}.bin", before_buildfs)  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        compress_assets(sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), "..", "data"))
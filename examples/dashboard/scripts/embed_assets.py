@@ -0,0 +1,177 @@
+"""
+Embed static assets into the firmware as gzip-compressed PROGMEM arrays.
+
+Files under data/assets get content-hashed names (app.js -> app.<hash>.js) and
+are served with immutable cache headers. Views are embedded under their own
+path with references to those assets rewritten to the fingerprinted URLs.
+The output is app/Generated/EmbeddedAssets.{h,cpp}; routes.cpp registers it
+with Router::assets() when it exists.
+
+Runs automatically before every PlatformIO build, or by hand:
+
+    python3 scripts/embed_assets.py [data_dir] [output_dir]
+"""
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+FINGERPRINTED_DIRS = ("assets",)
+VIEW_DIRS = ("views",)
+
+CONTENT_TYPES = {
+    ".css": "text/css",
+    ".gif": "image/gif",
+    ".htm": "text/html",
+    ".html": "text/html",
+    ".ico": "image/x-icon",
+    ".jpeg": "image/jpeg",
+    ".jpg": "image/jpeg",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".png": "image/png",
+    ".svg": "image/svg+xml",
+    ".txt": "text/plain",
+    ".webp": "image/webp",
+    ".woff": "font/woff",
+    ".woff2": "font/woff2",
+}
+
+# Already-compressed formats are embedded as they are
+PRECOMPRESSED = (".gif", ".jpeg", ".jpg", ".png", ".webp", ".woff", ".woff2")
+
+ASSET_REFERENCE = re.compile(r"""(["'(])(/(?:%s)/[^"')?#]+)""" % "|".join(FINGERPRINTED_DIRS))
+
+
+def content_hash(raw):
+    return hashlib.sha256(raw).hexdigest()[:10]
+
+
+def list_files(data_dir, directories):
+    for directory in directories:
+        root_dir = os.path.join(data_dir, directory)
+        for root, _, files in os.walk(root_dir):
+            for name in sorted(files):
+                ext = os.path.splitext(name)[1].lower()
+                if ext in CONTENT_TYPES:
+                    path = os.path.join(root, name)
+                    yield path, "/" + os.path.relpath(path, data_dir).replace(os.sep, "/")
+
+
+def make_asset(url, raw, immutable):
+    ext = os.path.splitext(url)[1].lower()
+    data = raw
+    gzipped = False
+    if ext not in PRECOMPRESSED:
+        # mtime=0 keeps the output stable between builds
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        if len(packed) < len(raw):
+            data, gzipped = packed, True
+    return {
+        "url": url,
+        "type": CONTENT_TYPES[ext],
+        "data": data,
+        "raw_size": len(raw),
+        "etag": content_hash(raw),
+        "gzipped": gzipped,
+        "immutable": immutable,
+    }
+
+
+def collect_assets(data_dir):
+    assets = []
+    fingerprints = {}
+
+    for path, url in list_files(data_dir, FINGERPRINTED_DIRS):
+        with open(path, "rb") as f:
+            raw = f.read()
+        stem, ext = os.path.splitext(url)
+        fingerprinted = "%s.%s%s" % (stem, content_hash(raw), ext)
+        fingerprints[url] = fingerprinted
+        assets.append(make_asset(fingerprinted, raw, True))
+
+    for path, url in list_files(data_dir, VIEW_DIRS):
+        with open(path, "rb") as f:
+            text = f.read().decode("utf-8")
+        text = ASSET_REFERENCE.sub(
+            lambda m: m.group(1) + fingerprints.get(m.group(2), m.group(2)), text)
+        assets.append(make_asset(url, text.encode("utf-8"), False))
+
+    return assets
+
+
+def c_bytes(data):
+    lines = []
+    for start in range(0, len(data), 20):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[start:start + 20]) + ",")
+    return "\n".join(lines)
+
+
+def write_if_changed(path, content):
+    # Unchanged output keeps the generated sources from being recompiled
+    if os.path.exists(path):
+        with open(path, "r") as f:
+            if f.read() == content:
+                return
+    with open(path, "w") as f:
+        f.write(content)
+
+
+def generate(data_dir, output_dir):
+    assets = collect_assets(data_dir)
+    os.makedirs(output_dir, exist_ok=True)
+
+    header = """// Generated by scripts/embed_assets.py - do not edit
+#ifndef EMBEDDED_ASSETS_H
+#define EMBEDDED_ASSETS_H
+
+#include <MVCFramework.h>
+
+extern const EmbeddedAsset embeddedAssets[];
+extern const size_t embeddedAssetCount;
+
+#endif
+"""
+
+    source = ["// Generated by scripts/embed_assets.py - do not edit",
+              '#include "EmbeddedAssets.h"', ""]
+    for index, asset in enumerate(assets):
+        source.append("// %s (%d bytes%s)" % (
+            asset["url"], asset["raw_size"], ", gzip %d" % len(asset["data"]) if asset["gzipped"] else ""))
+        source.append("static const uint8_t asset%d[] PROGMEM = {" % index)
+        source.append(c_bytes(asset["data"]))
+        source.append("};")
+        source.append("")
+
+    source.append("const EmbeddedAsset embeddedAssets[] = {")
+    for index, asset in enumerate(assets):
+        source.append('    {"%s", "%s", asset%d, sizeof(asset%d), "\\"%s\\"", %s, %s},' % (
+            asset["url"], asset["type"], index, index, asset["etag"],
+            "true" if asset["gzipped"] else "false",
+            "true" if asset["immutable"] else "false"))
+    source.append("};")
+    source.append("")
+    source.append("const size_t embeddedAssetCount = %d;" % len(assets))
+    source.append("")
+
+    write_if_changed(os.path.join(output_dir, "EmbeddedAssets.h"), header)
+    write_if_changed(os.path.join(output_dir, "EmbeddedAssets.cpp"), "\n".join(source))
+
+    total_raw = sum(asset["raw_size"] for asset in assets)
+    total_embedded = sum(len(asset["data"]) for asset in assets)
+    print("Embedded %d assets: %d -> %d bytes of flash" % (len(assets), total_raw, total_embedded))
+    for asset in assets:
+        print("  %-48s %8d -> %8d" % (asset["url"], asset["raw_size"], len(asset["data"])))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+
+    generate(env.subst("$PROJECT_DATA_DIR"),  # noqa: F821
+             os.path.join(env.subst("$PROJECT_SRC_DIR"), "Generated"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        base = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+        generate(sys.argv[1] if len(sys.argv) > 1 else os.path.join(base, "data"),
+                 sys.argv[2] if len(sys.argv) > 2 else os.path.join(base, "app", "Generated"))
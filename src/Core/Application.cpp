@@ -4,6 +4,10 @@
 #include "../Routing/Router.h"
 #include "../Http/Request.h"
 #include "../Http/Response.h"
+#include "../Http/Middleware.h"
+#include "../Http/AuthToken.h"
+#include "../Http/StaticFileCache.h"
+#include "../Http/ResponseCache.h"
 #include <memory>
 #include <ArduinoJson.h>
 
@@ -32,6 +36,23 @@ void Application::boot() {
     // Create web server
     AsyncWebServer* server = new AsyncWebServer(config->getServerPort());
     router = std::make_unique<Router>(server);
+    router->enableRouteCache(config->getInt("server.route_cache_size", 0));
+    Request::setMaxBodySize(config->getInt("server.max_body_size", Request::getMaxBodySize()));
+    Request::setPsramBodyThreshold(config->getInt("server.psram_body_threshold", Request::getPsramBodyThreshold()));
+    Response::setCompressionThreshold(config->getInt("server.compression_threshold", 0));
+    
+    size_t staticCacheSize = config->getInt("server.static_cache_size", 0);
+    if (staticCacheSize > 0) {
+        StaticFileCache::getInstance()->enableContentCache(staticCacheSize);
+    }
+    
+    ResponseCache::getInstance()->setBudget(config->getInt("server.response_cache_size", RESPONSE_CACHE_SIZE));
+    
+    // Tokens survive reboots only with a configured secret
+    String tokenSecret = config->get("app.token_secret");
+    if (tokenSecret.length() > 0) {
+        AuthToken::setSecret(tokenSecret);
+    }
     
     // Register core services
     registerProviders();
@@ -52,7 +73,10 @@ void Application::run() {
     registerRoutes();
     
     // Initialize router
-    router->init();
+    if (!router->init()) {
+        Serial.println("Failed to start web server: check middleware registration");
+        return;
+    }
     
     Serial.printf("Server started on port %d\n", config->getServerPort());
     Serial.printf("Environment: %s\n", config->getAppEnv().c_str());
@@ -72,16 +96,18 @@ void Application::registerProviders() {
 }
 
 void Application::registerMiddleware() {
-    // Register core middleware
-    // Note: These middleware classes need to be implemented
-    // router->registerMiddleware("cors", std::make_shared<CorsMiddleware>());
-    // router->registerMiddleware("auth", std::make_shared<AuthMiddleware>());
-    // router->registerMiddleware("logging", std::make_shared<LoggingMiddleware>());
-    // router->registerMiddleware("json", std::make_shared<JsonMiddleware>());
-    // router->registerMiddleware("ratelimit", std::make_shared<RateLimitMiddleware>());
-    
-    // For now, just register a basic middleware
-    Serial.println("Middleware registration placeholder - implement custom middleware classes as needed");
+    // Register core middleware; applications register their own before run()
+    router->registerMiddleware("cors", std::make_shared<CorsMiddleware>());
+    router->registerMiddleware("auth", std::make_shared<AuthMiddleware>());
+    router->registerMiddleware("logging", std::make_shared<LoggingMiddleware>());
+    router->registerMiddleware("json", std::make_shared<JsonMiddleware>());
+    router->registerMiddleware("ratelimit", std::make_shared<RateLimitMiddleware>());
+    router->registerMiddleware("cache", std::make_shared<ResponseCacheMiddleware>());
+    router->registerMiddleware("admission", std::make_shared<AdmissionControlMiddleware>(
+        config->getInt("server.max_in_flight", 8),
+        config->getInt("server.min_free_heap", 32768),
+        config->getInt("server.min_largest_block", 16384),
+        config->getInt("server.critical_min_heap", 12288)));
 }
 
 void Application::registerRoutes() {
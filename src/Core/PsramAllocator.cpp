@@ -0,0 +1,27 @@
+#include "PsramAllocator.h"
+#include <esp_heap_caps.h>
+
+void* PsramAllocator::allocate(size_t size) {
+    void* pointer = nullptr;
+    if (psramFound()) {
+        pointer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    return pointer ? pointer : malloc(size);
+}
+
+void PsramAllocator::deallocate(void* pointer) {
+    free(pointer);
+}
+
+void* PsramAllocator::reallocate(void* pointer, size_t newSize) {
+    void* resized = nullptr;
+    if (psramFound()) {
+        resized = heap_caps_realloc(pointer, newSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    return resized ? resized : realloc(pointer, newSize);
+}
+
+PsramAllocator* PsramAllocator::instance() {
+    static PsramAllocator allocator;
+    return &allocator;
+}
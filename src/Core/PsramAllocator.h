@@ -0,0 +1,17 @@
+#ifndef PSRAM_ALLOCATOR_H
+#define PSRAM_ALLOCATOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// ArduinoJson allocator that places documents in PSRAM, falling back to internal heap
+class PsramAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override;
+    void deallocate(void* pointer) override;
+    void* reallocate(void* pointer, size_t newSize) override;
+    
+    static PsramAllocator* instance();
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "AuthToken.h"
+#include <SHA256.h>
+#include <esp_timer.h>
+#include <time.h>
+
+// 16 bytes of HMAC encode to 22 base64url characters
+static const size_t signatureBytes = 16;
+static const size_t signatureLength = 22;
+
+// time() below this (2021-01-01) has not been set; expiries below it are seconds since boot
+static const uint32_t clockSetAfter = 1609459200;
+
+String AuthToken::secret;
+uint8_t AuthToken::bootNonce[8];
+bool AuthToken::bootNonceReady = false;
+
+static uint32_t uptimeSeconds() {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+static bool isRoleChar(char c) {
+    return isAlphaNumeric(c) || c == '_' || c == '-';
+}
+
+static void base64UrlEncode(const uint8_t* data, size_t length, char* output) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    size_t out = 0;
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t block = (uint32_t)data[i] << 16;
+        if (i + 1 < length) block |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < length) block |= data[i + 2];
+        
+        output[out++] = alphabet[(block >> 18) & 0x3f];
+        output[out++] = alphabet[(block >> 12) & 0x3f];
+        if (i + 1 < length) output[out++] = alphabet[(block >> 6) & 0x3f];
+        if (i + 2 < length) output[out++] = alphabet[block & 0x3f];
+    }
+    output[out] = '\0';
+}
+
+void AuthToken::setSecret(const String& key) {
+    secret = key;
+}
+
+bool AuthToken::isClockSet() {
+    return time(nullptr) >= (time_t)clockSetAfter;
+}
+
+void AuthToken::sign(const char* payload, size_t length, bool bootBound, char* signature) {
+    if (secret.length() == 0) {
+        uint8_t random[32];
+        for (size_t i = 0; i < sizeof(random); i += 4) {
+            uint32_t value = esp_random();
+            memcpy(random + i, &value, 4);
+        }
+        char encoded[44];
+        base64UrlEncode(random, sizeof(random), encoded);
+        secret = encoded;
+    }
+    
+    uint8_t mac[32];
+    SHA256 hash;
+    hash.resetHMAC(secret.c_str(), secret.length());
+    hash.update(payload, length);
+    if (bootBound) {
+        if (!bootNonceReady) {
+            for (size_t i = 0; i < sizeof(bootNonce); i += 4) {
+                uint32_t value = esp_random();
+                memcpy(bootNonce + i, &value, 4);
+            }
+            bootNonceReady = true;
+        }
+        hash.update(bootNonce, sizeof(bootNonce));
+    }
+    hash.finalizeHMAC(secret.c_str(), secret.length(), mac, sizeof(mac));
+    base64UrlEncode(mac, signatureBytes, signature);
+}
+
+bool AuthToken::constantTimeEquals(const char* a, const char* b, size_t length) {
+    uint8_t difference = 0;
+    for (size_t i = 0; i < length; i++) {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0;
+}
+
+String AuthToken::issue(uint32_t userId, const String& role, uint32_t ttlSeconds) {
+    if (role.length() == 0) return "";
+    for (size_t i = 0; i < role.length(); i++) {
+        if (!isRoleChar(role.charAt(i))) return "";
+    }
+    
+    bool bootBound = !isClockSet();
+    uint32_t expiresAt = bootBound ? uptimeSeconds() + ttlSeconds : (uint32_t)time(nullptr) + ttlSeconds;
+    if (bootBound && expiresAt >= clockSetAfter) return "";
+    
+    char token[96 + signatureLength];
+    int length = snprintf(token, sizeof(token) - signatureLength - 1, "%u.%s.%u",
+                          (unsigned int)userId, role.c_str(), (unsigned int)expiresAt);
+    if (length <= 0 || length >= (int)(sizeof(token) - signatureLength - 1)) return "";
+    
+    token[length] = '.';
+    sign(token, length, bootBound, token + length + 1);
+    return String(token);
+}
+
+bool AuthToken::verify(const String& token, TokenClaims& claims) {
+    const char* text = token.c_str();
+    int signatureDot = token.lastIndexOf('.');
+    if (signatureDot <= 0 || token.length() - signatureDot - 1 != signatureLength) {
+        return false;
+    }
+    
+    int roleDot = token.indexOf('.');
+    int expiryDot = token.indexOf('.', roleDot + 1);
+    if (roleDot <= 0 || expiryDot <= roleDot + 1 || expiryDot >= signatureDot) {
+        return false;
+    }
+    
+    // The expiry picks the signing scheme; changing it breaks the signature either way
+    uint32_t expiresAt = strtoul(text + expiryDot + 1, nullptr, 10);
+    bool bootBound = expiresAt < clockSetAfter;
+    
+    char expected[signatureLength + 1];
+    sign(text, signatureDot, bootBound, expected);
+    if (!constantTimeEquals(expected, text + signatureDot + 1, signatureLength)) {
+        return false;
+    }
+    
+    if (bootBound) {
+        if (uptimeSeconds() >= expiresAt) return false;
+    } else if (!isClockSet() || (uint32_t)time(nullptr) >= expiresAt) {
+        // Without a set clock a Unix expiry cannot be checked, so it is not trusted
+        return false;
+    }
+    
+    claims.userId = strtoul(text, nullptr, 10);
+    claims.role = token.substring(roleDot + 1, expiryDot);
+    claims.expiresAt = expiresAt;
+    claims.bootBound = bootBound;
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef AUTH_TOKEN_H
+#define AUTH_TOKEN_H
+
+#include <Arduino.h>
+
+// Lifetime of tokens issued without an explicit ttl
+#ifndef AUTH_TOKEN_TTL
+#define AUTH_TOKEN_TTL 86400
+#endif
+
+// Claims carried by a signed session token
+struct TokenClaims {
+    uint32_t userId = 0;
+    String role;
+    uint32_t expiresAt = 0; // time() seconds, or seconds since boot for boot-bound tokens
+    bool bootBound = false;
+};
+
+// Compact HMAC-SHA256 session tokens: "<userId>.<role>.<expiresAt>.<signature>".
+// The signature is the first 128 bits of the HMAC, base64url encoded, so a token
+// can be verified without touching the user database.
+//
+// Expiry needs a clock. Once time() has been set (configTime()/NTP), tokens carry a Unix
+// expiry and, with app.token_secret, stay valid across reboots. Before that, time() only
+// counts seconds since boot, so tokens are issued against the uptime instead and a random
+// per-boot nonce is folded into the signature: they end with the boot and are not cut
+// short when the clock is set later. Unix-time tokens are refused until the clock is set.
+class AuthToken {
+private:
+    static String secret;
+    static uint8_t bootNonce[8];
+    static bool bootNonceReady;
+    
+    static void sign(const char* payload, size_t length, bool bootBound, char* signature);
+    static bool constantTimeEquals(const char* a, const char* b, size_t length);
+
+public:
+    // Without a configured secret a random one is generated, so tokens end with the boot
+    static void setSecret(const String& key);
+    
+    // Whether time() holds a real date rather than seconds since boot
+    static bool isClockSet();
+    
+    // Empty when the role contains characters other than letters, digits, '_' and '-'
+    static String issue(uint32_t userId, const String& role, uint32_t ttlSeconds = AUTH_TOKEN_TTL);
+    
+    // Checks the signature in constant time, then the expiry; fills claims when valid
+    static bool verify(const String& token, TokenClaims& claims);
+};
+
+#endif
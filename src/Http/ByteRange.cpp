@@ -0,0 +1,76 @@
+#include "ByteRange.h"
+
+bool ByteRangeParser::parseSpec(const String& spec, size_t size, ByteRange& range, bool& satisfiable) {
+    int dash = spec.indexOf('-');
+    if (dash < 0) return false;
+    
+    String first = spec.substring(0, dash);
+    String last = spec.substring(dash + 1);
+    first.trim();
+    last.trim();
+    for (const String* part : {&first, &last}) {
+        for (size_t i = 0; i < part->length(); i++) {
+            if (!isDigit(part->charAt(i))) return false;
+        }
+    }
+    
+    if (first.length() == 0) {
+        // Suffix range: the last n bytes
+        if (last.length() == 0) return false;
+        size_t suffix = strtoul(last.c_str(), nullptr, 10);
+        satisfiable = suffix > 0 && size > 0;
+        range.start = suffix < size ? size - suffix : 0;
+        range.end = size > 0 ? size - 1 : 0;
+        return true;
+    }
+    
+    range.start = strtoul(first.c_str(), nullptr, 10);
+    range.end = last.length() > 0 ? strtoul(last.c_str(), nullptr, 10) : size - 1;
+    if (last.length() > 0 && range.end < range.start) return false;
+    
+    satisfiable = range.start < size;
+    if (range.end >= size) range.end = size - 1;
+    return true;
+}
+
+RangeSelection ByteRangeParser::select(const String& header, size_t size, std::vector<ByteRange>& ranges) {
+    ranges.clear();
+    if (!header.startsWith("bytes=")) return RANGE_FULL;
+    
+    std::vector<ByteRange> selected;
+    bool anySatisfiable = false;
+    int from = 6;
+    while (from <= (int)header.length()) {
+        int comma = header.indexOf(',', from);
+        if (comma < 0) comma = header.length();
+        
+        String spec = header.substring(from, comma);
+        spec.trim();
+        from = comma + 1;
+        if (spec.length() == 0) continue;
+        
+        ByteRange range;
+        bool satisfiable = false;
+        if (!parseSpec(spec, size, range, satisfiable)) {
+            return RANGE_FULL; // Malformed headers are ignored
+        }
+        if (satisfiable) {
+            selected.push_back(range);
+            anySatisfiable = true;
+        }
+        if (selected.size() > RESPONSE_MAX_RANGES) {
+            return RANGE_FULL;
+        }
+    }
+    
+    if (!anySatisfiable) return RANGE_UNSATISFIABLE;
+    ranges = std::move(selected);
+    return RANGE_PARTIAL;
+}
+
+bool ByteRangeParser::ifRangeMatches(const String& validator, const String& etag, const String& lastModified) {
+    if (validator.startsWith("\"")) {
+        return validator == etag;
+    }
+    return lastModified.length() > 0 && validator == lastModified;
+}
@@ -0,0 +1,39 @@
+#ifndef BYTE_RANGE_H
+#define BYTE_RANGE_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Maximum number of byte ranges honoured in one Range header; more are answered with the full file
+#ifndef RESPONSE_MAX_RANGES
+#define RESPONSE_MAX_RANGES 8
+#endif
+
+// Inclusive byte range of a file response
+struct ByteRange {
+    size_t start;
+    size_t end;
+};
+
+// What a Range header asks of a representation
+enum RangeSelection {
+    RANGE_FULL,          // No usable Range header: send the whole file with 200
+    RANGE_PARTIAL,       // Send the selected ranges with 206
+    RANGE_UNSATISFIABLE  // No range overlaps the file: answer 416
+};
+
+// Range and If-Range handling (RFC 7233) for file responses, independent of the request object
+class ByteRangeParser {
+public:
+    // Parses one "first-last", "first-" or "-suffix" spec; false when it is malformed
+    static bool parseSpec(const String& spec, size_t size, ByteRange& range, bool& satisfiable);
+    
+    // Selects the ranges of a "bytes=..." header value for a file of size bytes.
+    // Malformed headers, other units and more than RESPONSE_MAX_RANGES ranges fall back to the full file.
+    static RangeSelection select(const String& header, size_t size, std::vector<ByteRange>& ranges);
+    
+    // If-Range allows a partial response only while its ETag or date still matches the file
+    static bool ifRangeMatches(const String& validator, const String& etag, const String& lastModified);
+};
+
+#endif
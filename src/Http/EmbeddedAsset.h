@@ -0,0 +1,26 @@
+#ifndef EMBEDDED_ASSET_H
+#define EMBEDDED_ASSET_H
+
+#include <Arduino.h>
+#include <string.h>
+
+// Static file compiled into the firmware, usually generated at build time
+struct EmbeddedAsset {
+    const char* path;        // URL path, fingerprinted for immutable assets
+    const char* contentType;
+    const uint8_t* data;     // PROGMEM content, gzip-compressed when gzipped is set
+    size_t length;
+    const char* etag;        // Quoted strong ETag
+    bool gzipped;
+    bool immutable;          // Content-hashed name that can be cached forever
+};
+
+// Looks up an asset by its URL path
+inline const EmbeddedAsset* findEmbeddedAsset(const EmbeddedAsset* assets, size_t count, const char* path) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(assets[i].path, path) == 0) return &assets[i];
+    }
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include "GzipEncoder.h"
+#include <new>
+
+static const size_t windowSize = 1u << GZIP_WINDOW_BITS;
+static const size_t hashSize = 1u << GZIP_HASH_BITS;
+static const size_t minMatch = 3;
+static const size_t maxMatch = 258;
+
+static const uint16_t lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t distanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t distanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static inline size_t hash3(const uint8_t* data) {
+    uint32_t value = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    return (value * 2654435761u) >> (32 - GZIP_HASH_BITS);
+}
+
+GzipEncoder::GzipEncoder(const uint8_t* input, size_t length)
+    : input(input), length(length),
+      head(new (std::nothrow) uint16_t[hashSize]()),
+      prev(new (std::nothrow) uint16_t[windowSize]()) {
+}
+
+size_t GzipEncoder::read(uint8_t* output, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (pendingLength > 0) {
+            size_t count = min((size_t)pendingLength, maxLen - written);
+            memcpy(output + written, pending + pendingStart, count);
+            written += count;
+            pendingStart += count;
+            pendingLength -= count;
+            continue;
+        }
+        if (stage == DONE) break;
+        
+        pendingStart = 0;
+        encodeStep();
+    }
+    outputLength += written;
+    return written;
+}
+
+void GzipEncoder::encodeStep() {
+    if (stage == HEADER) {
+        // Magic, deflate, no flags, no mtime, no extra flags, unknown OS
+        static const uint8_t header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+        for (uint8_t value : header) writeByte(value);
+        
+        // One final block with fixed Huffman codes
+        writeBits(1, 1);
+        writeBits(1, 2);
+        stage = BODY;
+        return;
+    }
+    
+    if (stage == TRAILER) {
+        uint32_t crc = crc32();
+        for (int i = 0; i < 4; i++) writeByte((crc >> (8 * i)) & 0xff);
+        for (int i = 0; i < 4; i++) writeByte((length >> (8 * i)) & 0xff);
+        stage = DONE;
+        return;
+    }
+    
+    if (position >= length) {
+        writeHuffman(0, 7); // End of block
+        if (bitCount > 0) {
+            writeByte(bitBuffer & 0xff);
+            bitBuffer = 0;
+            bitCount = 0;
+        }
+        stage = TRAILER;
+        return;
+    }
+    
+    // Greedy match: follow the hash chain for the longest earlier occurrence in the window
+    size_t bestLength = 0;
+    size_t bestDistance = 0;
+    if (position + minMatch <= length) {
+        size_t limit = min(maxMatch, length - position);
+        uint16_t candidate = head[hash3(input + position)];
+        size_t previousDistance = 0;
+        
+        for (int chain = 0; chain < GZIP_MAX_CHAIN; chain++) {
+            size_t distance = (uint16_t)(position - candidate);
+            if (distance <= previousDistance || distance > windowSize || distance > position) break;
+            
+            const uint8_t* match = input + position - distance;
+            size_t matchLength = 0;
+            while (matchLength < limit && match[matchLength] == input[position + matchLength]) {
+                matchLength++;
+            }
+            if (matchLength > bestLength) {
+                bestLength = matchLength;
+                bestDistance = distance;
+                if (matchLength == limit) break;
+            }
+            
+            previousDistance = distance;
+            candidate = prev[(position - distance) & (windowSize - 1)];
+        }
+    }
+    
+    if (bestLength >= minMatch) {
+        writeMatch(bestLength, bestDistance);
+        for (size_t i = 0; i < bestLength; i++) {
+            insertHash(position + i);
+        }
+        position += bestLength;
+    } else {
+        writeLiteral(input[position]);
+        insertHash(position);
+        position++;
+    }
+}
+
+void GzipEncoder::insertHash(size_t at) {
+    if (at + minMatch > length) return;
+    size_t bucket = hash3(input + at);
+    prev[at & (windowSize - 1)] = head[bucket];
+    head[bucket] = (uint16_t)at;
+}
+
+void GzipEncoder::writeByte(uint8_t value) {
+    pending[pendingStart + pendingLength++] = value;
+}
+
+void GzipEncoder::writeBits(uint32_t bits, uint8_t count) {
+    // Deflate packs bits starting from the least significant bit of each byte
+    bitBuffer |= bits << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+        writeByte(bitBuffer & 0xff);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+void GzipEncoder::writeHuffman(uint16_t code, uint8_t count) {
+    // Huffman codes are stored most significant bit first
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    writeBits(reversed, count);
+}
+
+void GzipEncoder::writeLiteral(uint8_t value) {
+    if (value < 144) {
+        writeHuffman(0x30 + value, 8);
+    } else {
+        writeHuffman(0x190 + (value - 144), 9);
+    }
+}
+
+void GzipEncoder::writeMatch(size_t matchLength, size_t distance) {
+    int lengthCode = 28;
+    while (lengthBase[lengthCode] > matchLength) lengthCode--;
+    
+    uint16_t symbol = 257 + lengthCode;
+    if (symbol < 280) {
+        writeHuffman(symbol - 256, 7);
+    } else {
+        writeHuffman(0xc0 + (symbol - 280), 8);
+    }
+    writeBits(matchLength - lengthBase[lengthCode], lengthExtra[lengthCode]);
+    
+    int distanceCode = 29;
+    while (distanceBase[distanceCode] > distance) distanceCode--;
+    writeHuffman(distanceCode, 5);
+    writeBits(distance - distanceBase[distanceCode], distanceExtra[distanceCode]);
+}
+
+uint32_t GzipEncoder::crc32() const {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+    
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= input[i];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+    }
+    return ~crc;
+}
@@ -0,0 +1,66 @@
+#ifndef GZIP_ENCODER_H
+#define GZIP_ENCODER_H
+
+#include <Arduino.h>
+#include <memory>
+
+// LZ77 window; 4 KB keeps the match tables around 10 KB per response
+#ifndef GZIP_WINDOW_BITS
+#define GZIP_WINDOW_BITS 12
+#endif
+
+#ifndef GZIP_HASH_BITS
+#define GZIP_HASH_BITS 10
+#endif
+
+// Candidates checked per position before settling for the best match so far
+#ifndef GZIP_MAX_CHAIN
+#define GZIP_MAX_CHAIN 8
+#endif
+
+// Streaming gzip encoder for in-memory payloads: greedy LZ77 over a small window with the
+// fixed deflate Huffman codes, produced piecewise as the connection asks for more bytes
+class GzipEncoder {
+private:
+    enum Stage { HEADER, BODY, TRAILER, DONE };
+    
+    const uint8_t* input;
+    size_t length;
+    size_t position = 0;
+    Stage stage = HEADER;
+    
+    // Hash heads and chain links store positions modulo 65536; candidates are always verified
+    std::unique_ptr<uint16_t[]> head;
+    std::unique_ptr<uint16_t[]> prev;
+    
+    uint32_t bitBuffer = 0;
+    uint8_t bitCount = 0;
+    uint8_t pending[16];
+    uint8_t pendingStart = 0;
+    uint8_t pendingLength = 0;
+    size_t outputLength = 0;
+    
+    void writeByte(uint8_t value);
+    void writeBits(uint32_t bits, uint8_t count);
+    void writeHuffman(uint16_t code, uint8_t count);
+    void writeLiteral(uint8_t value);
+    void writeMatch(size_t matchLength, size_t distance);
+    void insertHash(size_t at);
+    void encodeStep();
+    uint32_t crc32() const;
+
+public:
+    // The input must stay valid until read() returns 0
+    GzipEncoder(const uint8_t* input, size_t length);
+    
+    // False when the match tables could not be allocated
+    bool isValid() const { return head && prev; }
+    
+    // Writes up to maxLen compressed bytes; returns 0 once the stream is complete
+    size_t read(uint8_t* output, size_t maxLen);
+    
+    size_t getInputLength() const { return length; }
+    size_t getOutputLength() const { return outputLength; }
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef HTTP_METHOD_H
+#define HTTP_METHOD_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// HTTP methods as single bits so a route can hold a mask of accepted methods
+enum HttpMethod : uint8_t {
+    METHOD_NONE    = 0,
+    METHOD_GET     = 1 << 0,
+    METHOD_POST    = 1 << 1,
+    METHOD_PUT     = 1 << 2,
+    METHOD_PATCH   = 1 << 3,
+    METHOD_DELETE  = 1 << 4,
+    METHOD_HEAD    = 1 << 5,
+    METHOD_OPTIONS = 1 << 6,
+    METHOD_ANY     = 0x7F
+};
+
+static const int HTTP_METHOD_COUNT = 7;
+
+inline HttpMethod toHttpMethod(WebRequestMethodComposite method) {
+    switch (method) {
+        case HTTP_GET: return METHOD_GET;
+        case HTTP_POST: return METHOD_POST;
+        case HTTP_PUT: return METHOD_PUT;
+        case HTTP_PATCH: return METHOD_PATCH;
+        case HTTP_DELETE: return METHOD_DELETE;
+        case HTTP_HEAD: return METHOD_HEAD;
+        case HTTP_OPTIONS: return METHOD_OPTIONS;
+        default: return METHOD_NONE;
+    }
+}
+
+// Bit position of a single method, used to index per-method tables
+inline int httpMethodIndex(HttpMethod method) {
+    return method == METHOD_NONE ? -1 : __builtin_ctz(method);
+}
+
+inline const char* httpMethodName(HttpMethod method) {
+    switch (method) {
+        case METHOD_GET: return "GET";
+        case METHOD_POST: return "POST";
+        case METHOD_PUT: return "PUT";
+        case METHOD_PATCH: return "PATCH";
+        case METHOD_DELETE: return "DELETE";
+        case METHOD_HEAD: return "HEAD";
+        case METHOD_OPTIONS: return "OPTIONS";
+        default: return "UNKNOWN";
+    }
+}
+
+#endif
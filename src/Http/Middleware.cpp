@@ -1,9 +1,19 @@
 #include "Middleware.h"
 #include "Request.h"
 #include "Response.h"
+#include "../Routing/Router.h"
+
+// MiddlewareChain implementation
+Response MiddlewareChain::operator()(Request& request) {
+    if (index < count) {
+        Middleware* current = middleware[index++];
+        return current->handle(request, *this);
+    }
+    return handler(request);
+}
 
 // AuthMiddleware implementation
-Response AuthMiddleware::handle(Request& request, std::function<Response(Request&)> next) {
+Response AuthMiddleware::handle(Request& request, MiddlewareChain& next) {
     // Check for authentication
     String token = request.header("Authorization");
     
@@ -24,11 +34,8 @@ Response AuthMiddleware::handle(Request& request, std::function<Response(Request
             .json(error);
     }
     
-    // Extract and validate token
-    String authToken = token.substring(7); // Remove "Bearer " prefix
-    
-    // Simple token validation - in production use proper JWT verification
-    if (!authToken.startsWith("cozmo_token_") || authToken.length() < 20) {
+    // Signature and expiry are checked without touching storage
+    if (!request.auth()) {
         if (!request.wantsJson()) {
             return Response(request.getServerRequest())
                 .redirect("/login?redirect=" + request.path());
@@ -52,9 +59,9 @@ CorsMiddleware::CorsMiddleware(const String& origins, const String& methods, con
     : allowedOrigins(origins), allowedMethods(methods), allowedHeaders(headers) {
 }
 
-Response CorsMiddleware::handle(Request& request, std::function<Response(Request&)> next) {
+Response CorsMiddleware::handle(Request& request, MiddlewareChain& next) {
     // Handle preflight requests
-    if (request.method() == "OPTIONS") {
+    if (request.isOptions()) {
         return Response(request.getServerRequest())
             .header("Access-Control-Allow-Origin", allowedOrigins)
             .header("Access-Control-Allow-Methods", allowedMethods)
@@ -76,67 +83,249 @@ Response CorsMiddleware::handle(Request& request, std::function<Response(Request
 }
 
 // RateLimitMiddleware implementation
-RateLimitMiddleware::RateLimitMiddleware(int max, unsigned long window)
-    : maxRequests(max), windowMs(window) {
+RateLimitMiddleware::RateLimitMiddleware(int max, unsigned long window, size_t maxClients)
+    : maxRequests(max), windowMs(window), maxClients(maxClients > 0 ? maxClients : 1) {
+    // Keep the load factor at or below 3/4 so probe sequences stay short
+    size_t slotCount = 1;
+    slotShift = 32;
+    while (slotCount * 3 < this->maxClients * 4) {
+        slotCount <<= 1;
+        slotShift--;
+    }
+    slotMask = slotCount - 1;
+    slots.reset(new Bucket[slotCount]());
 }
 
-Response RateLimitMiddleware::handle(Request& request, std::function<Response(Request&)> next) {
-    String clientIp = request.ip();
+Response RateLimitMiddleware::handle(Request& request, MiddlewareChain& next) {
+    uint32_t address = request.ipAddress();
     unsigned long now = millis();
+    const uint32_t fullBucket = (uint32_t)maxRequests * 1000;
     
-    // Cleanup old entries
-    cleanup();
-    
-    // Check current request count for this IP
-    auto it = requests.find(clientIp);
-    if (it != requests.end()) {
-        if (now - it->second.second < windowMs) {
-            if (it->second.first >= maxRequests) {
-                JsonDocument error;
-                error["error"] = "Too Many Requests";
-                error["message"] = "Rate limit exceeded";
-                error["retry_after"] = (windowMs - (now - it->second.second)) / 1000;
-                
-                return Response(request.getServerRequest())
-                    .status(429)
-                    .header("Retry-After", String((windowMs - (now - it->second.second)) / 1000))
-                    .json(error);
-            }
-            it->second.first++;
+    // Expire a couple of idle clients per request instead of walking the whole table
+    sweep(2, now);
+    
+    Bucket* bucket = find(address);
+    if (bucket) {
+        // Refill for the time since the last refill, capped at the bucket size. Only the time the
+        // refill paid for (rounded up) is consumed, so retries faster than one milli-token still add up.
+        uint64_t refill = (uint64_t)(now - bucket->updatedAt) * fullBucket / windowMs;
+        if (bucket->milliTokens + refill >= fullBucket) {
+            bucket->milliTokens = fullBucket;
+            bucket->updatedAt = now;
         } else {
-            // Reset counter for new window
-            it->second.first = 1;
-            it->second.second = now;
+            bucket->milliTokens += (uint32_t)refill;
+            bucket->updatedAt += (unsigned long)((refill * windowMs + fullBucket - 1) / fullBucket);
         }
     } else {
-        // First request from this IP
-        requests[clientIp] = {1, now};
+        bucket = insert(address, now);
+    }
+    bucket->referenced = true;
+    
+    if (bucket->milliTokens < 1000) {
+        // Seconds until one whole token has been refilled
+        unsigned long waitMs = (uint64_t)(1000 - bucket->milliTokens) * windowMs / fullBucket;
+        unsigned long retryAfter = (waitMs + 999) / 1000;
+        
+        JsonDocument error;
+        error["error"] = "Too Many Requests";
+        error["message"] = "Rate limit exceeded";
+        error["retry_after"] = retryAfter;
+        
+        return Response(request.getServerRequest())
+            .status(429)
+            .header("Retry-After", String(retryAfter))
+            .json(error);
     }
     
+    bucket->milliTokens -= 1000;
     return next(request);
 }
 
-void RateLimitMiddleware::cleanup() {
-    unsigned long now = millis();
-    auto it = requests.begin();
+size_t RateLimitMiddleware::slotFor(uint32_t address) const {
+    // Fibonacci hashing: the high bits of the product depend on every octet, while the low
+    // bits would only see the first one (IPAddress keeps it in the low byte), putting a
+    // whole subnet in one slot
+    return (uint32_t)(address * 2654435761u) >> slotShift;
+}
+
+RateLimitMiddleware::Bucket* RateLimitMiddleware::find(uint32_t address) {
+    for (size_t slot = slotFor(address); slots[slot].address != 0; slot = (slot + 1) & slotMask) {
+        if (slots[slot].address == address) return &slots[slot];
+    }
+    return nullptr;
+}
+
+RateLimitMiddleware::Bucket* RateLimitMiddleware::insert(uint32_t address, unsigned long now) {
+    if (clientCount >= maxClients) {
+        evict(now);
+    }
     
-    while (it != requests.end()) {
-        if (now - it->second.second > windowMs) {
-            it = requests.erase(it);
-        } else {
-            ++it;
+    size_t slot = slotFor(address);
+    while (slots[slot].address != 0) {
+        slot = (slot + 1) & slotMask;
+    }
+    
+    Bucket& bucket = slots[slot];
+    bucket.address = address;
+    bucket.milliTokens = (uint32_t)maxRequests * 1000;
+    bucket.updatedAt = now;
+    bucket.referenced = false;
+    clientCount++;
+    return &bucket;
+}
+
+void RateLimitMiddleware::remove(size_t slot) {
+    // Backward-shift deletion keeps every probe sequence unbroken without tombstones
+    size_t hole = slot;
+    size_t next = (hole + 1) & slotMask;
+    while (slots[next].address != 0) {
+        size_t home = slotFor(slots[next].address);
+        // Move the entry back if its home slot is not between the hole and where it sits
+        if (((next - home) & slotMask) >= ((next - hole) & slotMask)) {
+            slots[hole] = slots[next];
+            hole = next;
         }
+        next = (next + 1) & slotMask;
     }
+    slots[hole] = Bucket();
+    clientCount--;
+}
+
+bool RateLimitMiddleware::isExpired(const Bucket& bucket, unsigned long now) const {
+    // A bucket idle for a whole window is full again, the same as not tracking it
+    return now - bucket.updatedAt >= windowMs;
+}
+
+void RateLimitMiddleware::sweep(size_t steps, unsigned long now) {
+    for (size_t i = 0; i < steps && clientCount > 0; i++) {
+        Bucket& bucket = slots[clockHand];
+        if (bucket.address != 0 && isExpired(bucket, now)) {
+            // Another entry may shift into this slot, so look at it again next time
+            remove(clockHand);
+            continue;
+        }
+        clockHand = (clockHand + 1) & slotMask;
+    }
+}
+
+void RateLimitMiddleware::evict(unsigned long now) {
+    // Clock sweep: idle clients go first, recently seen ones get a second chance
+    for (size_t i = 0; i <= 2 * (slotMask + 1); i++) {
+        Bucket& bucket = slots[clockHand];
+        if (bucket.address != 0) {
+            if (isExpired(bucket, now) || !bucket.referenced) {
+                remove(clockHand);
+                evictions++;
+                return;
+            }
+            bucket.referenced = false;
+        }
+        clockHand = (clockHand + 1) & slotMask;
+    }
+}
+
+// ResponseCacheMiddleware implementation
+ResponseCacheMiddleware::ResponseCacheMiddleware(unsigned long defaultTtl) : defaultTtl(defaultTtl) {
+}
+
+Response ResponseCacheMiddleware::handle(Request& request, MiddlewareChain& next) {
+    ResponseCache* cache = ResponseCache::getInstance();
+    if (!cache->isEnabled()) {
+        return next(request);
+    }
+    
+    // Writes through this middleware make cached reads of the same path stale
+    if (!request.is(METHOD_GET | METHOD_HEAD)) {
+        Response response = next(request);
+        if (response.getStatusCode() >= 200 && response.getStatusCode() < 300) {
+            cache->invalidate(request.path());
+        }
+        return response;
+    }
+    
+    const Route* route = request.matchedRoute();
+    unsigned long ttl = route && route->cacheTtl > 0 ? route->cacheTtl : defaultTtl;
+    
+    String key = cache->keyFor(request);
+    Response cached(request.getServerRequest());
+    if (cache->lookup(key, cached)) {
+        return cached;
+    }
+    
+    Response response = next(request);
+    cache->store(key, request.path(), response, ttl);
+    return response;
+}
+
+// AdmissionControlMiddleware implementation
+AdmissionControlMiddleware::AdmissionControlMiddleware(size_t maxInFlight, size_t minFreeHeap, size_t minLargestBlock,
+                                                       size_t criticalMinHeap, unsigned long retryAfterSeconds)
+    : maxInFlight(maxInFlight), minFreeHeap(minFreeHeap), minLargestBlock(minLargestBlock),
+      criticalMinHeap(criticalMinHeap), retryAfter(retryAfterSeconds) {
+}
+
+Response AdmissionControlMiddleware::handle(Request& request, MiddlewareChain& next) {
+    const Route* route = request.matchedRoute();
+    bool critical = route && route->critical;
+    size_t freeHeap = ESP.getFreeHeap();
+    
+    if (critical) {
+        if (freeHeap < criticalMinHeap) {
+            shedForHeap++;
+            return reject(request, "Server is low on memory");
+        }
+    } else if (freeHeap < minFreeHeap || ESP.getMaxAllocHeap() < minLargestBlock) {
+        // A fragmented heap fails large allocations even with plenty free in total
+        shedForHeap++;
+        return reject(request, "Server is low on memory");
+    } else if (inFlight >= maxInFlight) {
+        shedForLoad++;
+        return reject(request, "Too many requests in progress");
+    }
+    
+    AsyncWebServerRequest* serverRequest = request.getServerRequest();
+    if (serverRequest) {
+        inFlight++;
+        peakInFlight = max(peakInFlight, inFlight);
+        
+        Request::onDisconnect(serverRequest, [this]() {
+            if (inFlight > 0) {
+                inFlight--;
+            }
+        });
+    }
+    admitted++;
+    
+    return next(request);
+}
+
+Response AdmissionControlMiddleware::reject(Request& request, const char* reason) {
+    JsonDocument error;
+    error["error"] = "Service Unavailable";
+    error["message"] = reason;
+    error["retry_after"] = retryAfter;
+    
+    return Response(request.getServerRequest())
+        .status(503)
+        .header("Retry-After", String(retryAfter))
+        .json(error);
+}
+
+void AdmissionControlMiddleware::resetStats() {
+    peakInFlight = inFlight;
+    admitted = 0;
+    shedForLoad = 0;
+    shedForHeap = 0;
 }
 
 // LoggingMiddleware implementation
-Response LoggingMiddleware::handle(Request& request, std::function<Response(Request&)> next) {
+Response LoggingMiddleware::handle(Request& request, MiddlewareChain& next) {
     unsigned long startTime = millis();
     
     // Log request
     Serial.printf("[%lu] %s %s from %s\n", 
                   startTime, 
-                  request.method().c_str(), 
+                  httpMethodName(request.httpMethod()), 
                   request.path().c_str(), 
                   request.ip().c_str());
     
@@ -145,22 +334,23 @@ Response LoggingMiddleware::handle(Request& request, std::function<Response(Requ
     
     // Log response
     unsigned long duration = millis() - startTime;
-    Serial.printf("[%lu] Response: %d in %lums\n", 
+    Serial.printf("[%lu] Response: %d in %lums (%u request strings copied)\n", 
                   millis(), 
                   response.getStatusCode(), 
-                  duration);
+                  duration,
+                  request.copiedStrings());
     
     return response;
 }
 
 // JsonMiddleware implementation
-Response JsonMiddleware::handle(Request& request, std::function<Response(Request&)> next) {
+Response JsonMiddleware::handle(Request& request, MiddlewareChain& next) {
     // Set default content type for API responses
     Response response = next(request);
     
     // If no content type is set and we have content, assume JSON
     if (response.getContentType() == "text/html" && 
-        response.getContent().startsWith("{")) {
+        response.getBody().startsWith("{")) {
         response.contentType("application/json");
     }
     
@@ -3,22 +3,39 @@
 
 #include <Arduino.h>
 #include <functional>
-#include <map>
+#include <memory>
+#include "ResponseCache.h"
 
 // Forward declarations
 class Request;
 class Response;
+class Middleware;
+
+// Cursor over a route's resolved middleware pipeline; calling it runs the next layer
+class MiddlewareChain {
+private:
+    Middleware* const* middleware;
+    size_t count;
+    size_t index;
+    const std::function<Response(Request&)>& handler;
+
+public:
+    MiddlewareChain(Middleware* const* middleware, size_t count, const std::function<Response(Request&)>& handler)
+        : middleware(middleware), count(count), index(0), handler(handler) {}
+    
+    Response operator()(Request& request);
+};
 
 class Middleware {
 public:
     virtual ~Middleware() = default;
-    virtual Response handle(Request& request, std::function<Response(Request&)> next) = 0;
+    virtual Response handle(Request& request, MiddlewareChain& next) = 0;
 };
 
 // Auth middleware
 class AuthMiddleware : public Middleware {
 public:
-    Response handle(Request& request, std::function<Response(Request&)> next) override;
+    Response handle(Request& request, MiddlewareChain& next) override;
 };
 
 // CORS middleware
@@ -33,34 +50,103 @@ public:
                    const String& methods = "GET,POST,PUT,DELETE,PATCH,OPTIONS",
                    const String& headers = "Content-Type,Authorization");
     
-    Response handle(Request& request, std::function<Response(Request&)> next) override;
+    Response handle(Request& request, MiddlewareChain& next) override;
 };
 
-// Rate limiting middleware
+// Token-bucket rate limiter over a fixed open-addressing table keyed by IPv4 address.
+// Idle clients are expired a few slots per request by a clock sweep; when the table is
+// full the sweep evicts the first client that has not been seen since its last pass.
 class RateLimitMiddleware : public Middleware {
 private:
+    struct Bucket {
+        uint32_t address;       // 0 marks an empty slot
+        uint32_t milliTokens;   // Remaining requests x 1000
+        unsigned long updatedAt;
+        bool referenced;
+    };
+    
     int maxRequests;
     unsigned long windowMs;
-    std::map<String, std::pair<int, unsigned long>> requests;
+    size_t maxClients;
+    size_t slotMask;
+    uint8_t slotShift;          // 32 - log2(slot count): the hash keeps the top bits
+    size_t clientCount = 0;
+    size_t clockHand = 0;
+    unsigned long evictions = 0;
+    std::unique_ptr<Bucket[]> slots;
 
 public:
-    RateLimitMiddleware(int max = 100, unsigned long window = 60000); // 100 requests per minute
-    Response handle(Request& request, std::function<Response(Request&)> next) override;
+    // max requests per window for each client, tracking at most maxClients addresses
+    RateLimitMiddleware(int max = 100, unsigned long window = 60000, size_t maxClients = 128); // 100 requests per minute
+    Response handle(Request& request, MiddlewareChain& next) override;
+    
+    size_t getClientCount() const { return clientCount; }
+    unsigned long getEvictions() const { return evictions; }
     
 private:
-    void cleanup();
+    size_t slotFor(uint32_t address) const;
+    Bucket* find(uint32_t address);
+    Bucket* insert(uint32_t address, unsigned long now);
+    void remove(size_t slot);
+    bool isExpired(const Bucket& bucket, unsigned long now) const;
+    void sweep(size_t steps, unsigned long now);
+    void evict(unsigned long now);
+};
+
+// Memoizes GET/HEAD responses in ResponseCache for the route's cache() TTL, or defaultTtl
+// when the middleware is attached by name; other methods invalidate their path on success
+class ResponseCacheMiddleware : public Middleware {
+private:
+    unsigned long defaultTtl;
+
+public:
+    ResponseCacheMiddleware(unsigned long defaultTtl = RESPONSE_CACHE_TTL);
+    Response handle(Request& request, MiddlewareChain& next) override;
+};
+
+// Sheds load with 503 and Retry-After when too many requests are in flight or the heap runs low.
+// Routes marked critical() are admitted past both limits until free heap drops below criticalMinHeap.
+// Requests are rejected rather than queued: handlers share the server task, and waiting there
+// would also hold up the responses whose completion frees the memory.
+class AdmissionControlMiddleware : public Middleware {
+private:
+    size_t maxInFlight;
+    size_t minFreeHeap;
+    size_t minLargestBlock;
+    size_t criticalMinHeap;
+    unsigned long retryAfter;
+    size_t inFlight = 0; // Admitted requests whose connection is still open
+    size_t peakInFlight = 0;
+    unsigned long admitted = 0;
+    unsigned long shedForLoad = 0;
+    unsigned long shedForHeap = 0;
+    
+    Response reject(Request& request, const char* reason);
+
+public:
+    AdmissionControlMiddleware(size_t maxInFlight = 8, size_t minFreeHeap = 32768, size_t minLargestBlock = 16384,
+                               size_t criticalMinHeap = 12288, unsigned long retryAfterSeconds = 2);
+    Response handle(Request& request, MiddlewareChain& next) override;
+    
+    size_t getInFlight() const { return inFlight; }
+    size_t getPeakInFlight() const { return peakInFlight; }
+    unsigned long getAdmitted() const { return admitted; }
+    unsigned long getShedForLoad() const { return shedForLoad; }
+    unsigned long getShedForHeap() const { return shedForHeap; }
+    unsigned long getShedCount() const { return shedForLoad + shedForHeap; }
+    void resetStats();
 };
 
 // Logging middleware
 class LoggingMiddleware : public Middleware {
 public:
-    Response handle(Request& request, std::function<Response(Request&)> next) override;
+    Response handle(Request& request, MiddlewareChain& next) override;
 };
 
 // JSON middleware
 class JsonMiddleware : public Middleware {
 public:
-    Response handle(Request& request, std::function<Response(Request&)> next) override;
+    Response handle(Request& request, MiddlewareChain& next) override;
 };
 
 #endif
@@ -1,87 +1,348 @@
 #include "Request.h"
+#include "StaticFileCache.h"
+#include "../Core/PsramAllocator.h"
 
-// Static variable to store body data between handlers
-static String requestBodyData;
+#include <esp_heap_caps.h>
+#include <new>
+
+size_t Request::maxBodySize = 32768;
+size_t Request::psramBodyThreshold = 4096;
+
+// Raw body buffered by the body handler. The header and data share one
+// allocation stored in _tempObject, which AsyncWebServerRequest frees.
+struct RequestBody {
+    size_t length;
+    size_t capacity;
+    int error; // HTTP status to reply with instead of dispatching, 0 if none
+    
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+};
+
+static RequestBody* allocateRequestBody(size_t total) {
+    size_t size = sizeof(RequestBody) + total + 1;
+    void* memory = nullptr;
+    
+    // Large bodies go to PSRAM when available, keeping internal RAM for the stack
+    if (total >= Request::getPsramBodyThreshold() && psramFound()) {
+        memory = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!memory) {
+        memory = malloc(size);
+    }
+    if (!memory) {
+        return nullptr;
+    }
+    
+    RequestBody* body = new (memory) RequestBody{0, total, 0};
+    body->data()[0] = '\0';
+    return body;
+}
+
+static RequestBody* rejectRequestBody(int status) {
+    void* memory = malloc(sizeof(RequestBody));
+    if (!memory) {
+        return nullptr;
+    }
+    return new (memory) RequestBody{0, 0, status};
+}
 
 // Body handler callback function
 void handleRequestBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    if (total > 0 && data != nullptr) {
-        if (index == 0) {
-            requestBodyData = "";
+    if (total == 0 || data == nullptr) {
+        return;
+    }
+    
+    RequestBody* body = static_cast<RequestBody*>(request->_tempObject);
+    
+    if (index == 0 && body == nullptr) {
+        // Reject oversized uploads before buffering anything
+        if (total > Request::getMaxBodySize()) {
+            request->_tempObject = rejectRequestBody(413);
+            return;
         }
         
-        for (size_t i = 0; i < len; i++) {
-            requestBodyData += (char)data[i];
+        body = allocateRequestBody(total);
+        request->_tempObject = body ? body : rejectRequestBody(503);
+        if (!body) {
+            return;
+        }
+    }
+    
+    if (body == nullptr || body->error != 0 || index >= body->capacity) {
+        return;
+    }
+    
+    if (index + len > body->capacity) {
+        len = body->capacity - index;
+    }
+    memcpy(body->data() + index, data, len);
+    if (index + len > body->length) {
+        body->length = index + len;
+        body->data()[body->length] = '\0';
+    }
+}
+
+// Upload destination, set by enableUploads()
+static FS* uploadStorage = nullptr;
+static String uploadDirectory;
+static size_t maxUploadSize = 0;
+static uint32_t uploadSequence = 0;
+
+// In-progress uploads; handed to the Request at dispatch or dropped on disconnect
+struct UploadState {
+    std::vector<UploadedFile> files;
+    File current;
+    unsigned long startedAt = 0;
+    size_t total = 0;
+    int error = 0;
+};
+
+static std::map<AsyncWebServerRequest*, UploadState*> uploadStates;
+
+// Disconnect callbacks per request, run in registration order by the one handler installed on it
+static std::map<AsyncWebServerRequest*, std::vector<std::function<void()>>> disconnectCallbacks;
+
+void Request::onDisconnect(AsyncWebServerRequest* request, std::function<void()> callback) {
+    auto it = disconnectCallbacks.find(request);
+    if (it != disconnectCallbacks.end()) {
+        it->second.push_back(std::move(callback));
+        return;
+    }
+    
+    disconnectCallbacks[request].push_back(std::move(callback));
+    request->onDisconnect([request]() {
+        auto entry = disconnectCallbacks.find(request);
+        if (entry == disconnectCallbacks.end()) return;
+        std::vector<std::function<void()>> callbacks = std::move(entry->second);
+        disconnectCallbacks.erase(entry);
+        for (const auto& callback : callbacks) {
+            callback();
+        }
+    });
+}
+
+static String uploadPath(const String& filename) {
+    // Keep only the base name so clients cannot escape the upload directory
+    int slash = max(filename.lastIndexOf('/'), filename.lastIndexOf('\\'));
+    String name = filename.substring(slash + 1);
+    if (name.length() == 0 || name == "." || name == "..") {
+        name = "upload";
+    }
+    return uploadDirectory + "/" + name;
+}
+
+// Parts are written under a unique temporary name so a rejected upload never touches the destination
+static String temporaryUploadPath() {
+    return uploadDirectory + "/.upload-" + String(++uploadSequence);
+}
+
+static void failUpload(UploadState* state, int status) {
+    state->error = status;
+    if (state->current) {
+        state->current.close();
+    }
+    for (const UploadedFile& file : state->files) {
+        uploadStorage->remove(file.path);
+    }
+}
+
+static void releaseUploadState(AsyncWebServerRequest* request) {
+    auto it = uploadStates.find(request);
+    if (it == uploadStates.end()) {
+        return;
+    }
+    
+    // Request never reached a handler; discard what was written
+    UploadState* state = it->second;
+    if (state->error == 0) {
+        failUpload(state, 500);
+    }
+    delete state;
+    uploadStates.erase(it);
+}
+
+// Upload handler callback function; receives one chunk of one file part at a time
+void handleFileUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final) {
+    if (!uploadStorage) {
+        return;
+    }
+    
+    UploadState* state;
+    auto it = uploadStates.find(request);
+    if (it == uploadStates.end()) {
+        state = new UploadState();
+        uploadStates[request] = state;
+        Request::onDisconnect(request, [request]() {
+            releaseUploadState(request);
+        });
+    } else {
+        state = it->second;
+    }
+    
+    if (state->error != 0) {
+        return;
+    }
+    
+    if (index == 0) {
+        if (state->current) {
+            state->current.close();
         }
         
-        if (index + len == total) {
-            // Store in request
-            request->_tempObject = new String(requestBodyData);
+        UploadedFile file;
+        file.filename = filename;
+        file.destination = uploadPath(filename);
+        file.path = temporaryUploadPath();
+        state->current = uploadStorage->open(file.path, FILE_WRITE);
+        if (!state->current) {
+            Serial.println("[Upload] Unable to create " + file.path);
+            failUpload(state, 500);
+            return;
         }
+        state->files.push_back(file);
+        state->startedAt = millis();
+    }
+    
+    if (state->files.empty() || !state->current) {
+        return;
+    }
+    
+    UploadedFile& file = state->files.back();
+    if (state->total + len > maxUploadSize) {
+        Serial.printf("[Upload] %s exceeds %u bytes, rejected\n", filename.c_str(), maxUploadSize);
+        failUpload(state, 413);
+        return;
+    }
+    
+    if (len > 0 && state->current.write(data, len) != len) {
+        Serial.println("[Upload] Write failed for " + file.destination);
+        failUpload(state, 507);
+        return;
+    }
+    file.size += len;
+    state->total += len;
+    
+    if (final) {
+        state->current.close();
+        file.durationMs = millis() - state->startedAt;
+        file.complete = true;
+        Serial.printf("[Upload] %s: %u bytes in %lums (%u B/s)\n", 
+                      file.destination.c_str(), file.size, file.durationMs, file.bytesPerSecond());
     }
 }
 
 // Static method to set up body handling for the server
 void Request::setupBodyHandling(AsyncWebServer* server) {
     server->onRequestBody(handleRequestBody);
+    server->onFileUpload(handleFileUpload);
 }
 
-Request::Request(AsyncWebServerRequest* request) : serverRequest(request) {
-    // Extract headers
-    int headerCount = request->headers();
-    for (int i = 0; i < headerCount; i++) {
-        const AsyncWebHeader* header = request->getHeader(i);
-        headers[header->name()] = header->value();
+void Request::finishUploads(int statusCode) {
+    if (uploadedFiles.empty() || !uploadStorage) {
+        return;
     }
     
-    // Extract parameters
-    int paramCount = request->params();
-    for (int i = 0; i < paramCount; i++) {
-        const AsyncWebParameter* param = request->getParam(i);
-        parameters[param->name()] = param->value();
+    bool accepted = statusCode >= 200 && statusCode < 300;
+    for (UploadedFile& file : uploadedFiles) {
+        // The handler may already have moved or removed the file
+        if (file.path == file.destination || !uploadStorage->exists(file.path)) {
+            continue;
+        }
+        if (!accepted || !file.complete) {
+            uploadStorage->remove(file.path);
+            continue;
+        }
         
-        // Check if this parameter is the request body (POST data)
-        if (param->isPost()) {
-            if (param->name() == "plain" || param->name() == "body" || param->name() == "") {
-                body = param->value();
+        // SPIFFS does not rename over an existing file; the old copy is only dropped once the new one is complete
+        if (!uploadStorage->rename(file.path, file.destination)) {
+            uploadStorage->remove(file.destination);
+            if (!uploadStorage->rename(file.path, file.destination)) {
+                Serial.println("[Upload] Unable to move upload to " + file.destination);
+                uploadStorage->remove(file.path);
+                continue;
             }
         }
+        StaticFileCache::getInstance()->invalidate(file.destination);
+        file.path = file.destination;
     }
+}
+
+void Request::enableUploads(FS& storage, const String& directory, size_t maxSize) {
+    uploadStorage = &storage;
+    uploadDirectory = directory.endsWith("/") ? directory.substring(0, directory.length() - 1) : directory;
+    maxUploadSize = maxSize;
     
-    // Also try to get body from specific body parameters
+    if (uploadDirectory.length() > 0 && !storage.exists(uploadDirectory)) {
+        storage.mkdir(uploadDirectory);
+    }
+}
+
+void Request::disableUploads() {
+    uploadStorage = nullptr;
+}
+
+int Request::bodyError(AsyncWebServerRequest* request) {
+    if (!request) {
+        return 0;
+    }
+    
+    auto upload = uploadStates.find(request);
+    if (upload != uploadStates.end() && upload->second->error != 0) {
+        return upload->second->error;
+    }
+    
+    RequestBody* body = static_cast<RequestBody*>(request->_tempObject);
+    return body ? body->error : 0;
+}
+
+Request::Request(AsyncWebServerRequest* request) 
+    : serverRequest(request), requestMethod(request ? toHttpMethod(request->method()) : METHOD_NONE) {
+    // Headers and parameters are read from the server request on demand
+    if (!request) {
+        return;
+    }
+    
+    // Take over files streamed to storage during the upload
+    auto upload = uploadStates.find(request);
+    if (upload != uploadStates.end()) {
+        uploadedFiles = std::move(upload->second->files);
+        delete upload->second;
+        uploadStates.erase(upload);
+        
+        // The server records each file part as a parameter named after its form field
+        size_t paramCount = request->params();
+        for (size_t i = 0; i < paramCount; i++) {
+            const AsyncWebParameter* param = request->getParam(i);
+            if (!param->isFile()) {
+                continue;
+            }
+            for (UploadedFile& file : uploadedFiles) {
+                if (file.field.isEmpty() && file.filename == param->value()) {
+                    file.field = param->name();
+                    break;
+                }
+            }
+        }
+    }
+    
+    // Form posts carry the body as a parameter; reference it without copying
     const AsyncWebParameter* bodyParam = request->getParam("body", true);
     if (!bodyParam) {
         bodyParam = request->getParam("plain", true);
     }
     
     if (bodyParam) {
-        body = bodyParam->value();
-    }
-    
-    // Check for raw body data stored by the body handler
-    if (body.isEmpty() && request->_tempObject != nullptr) {
-        // Get the body from the temporary object
-        String* tempBody = static_cast<String*>(request->_tempObject);
-        body = *tempBody;
-        
-        // Clean up (don't delete - the server will do this)
-        // delete tempBody;
-        // request->_tempObject = nullptr;
+        rawBodyData = bodyParam->value().c_str();
+        rawBodyLength = bodyParam->value().length();
+        return;
     }
-}
-
-String Request::method() const {
-    if (!serverRequest) return "";
     
-    switch (serverRequest->method()) {
-        case HTTP_GET: return "GET";
-        case HTTP_POST: return "POST";
-        case HTTP_PUT: return "PUT";
-        case HTTP_DELETE: return "DELETE";
-        case HTTP_PATCH: return "PATCH";
-        case HTTP_HEAD: return "HEAD";
-        case HTTP_OPTIONS: return "OPTIONS";
-        default: return "UNKNOWN";
+    // Reference the raw body buffered by the body handler; it lives as long as the server request
+    if (request->_tempObject != nullptr) {
+        RequestBody* rawBody = static_cast<RequestBody*>(request->_tempObject);
+        if (rawBody->error == 0) {
+            rawBodyData = rawBody->data();
+            rawBodyLength = rawBody->length;
+        }
     }
 }
 
@@ -109,13 +370,28 @@ String Request::query() const {
 }
 
 String Request::input(const String& key, const String& defaultValue) const {
-    return get(key, defaultValue);
+    const String* value = paramValue(key);
+    if (value) {
+        copiedStringCount++;
+        return *value;
+    }
+    
+    // Fall back to top-level fields of a JSON body
+    if (isJson()) {
+        JsonVariantConst field = json()[key];
+        if (!field.isNull()) {
+            copiedStringCount++;
+            return field.as<String>();
+        }
+    }
+    return defaultValue;
 }
 
 String Request::get(const String& key, const String& defaultValue) const {
-    auto it = parameters.find(key);
-    if (it != parameters.end()) {
-        return it->second;
+    const String* value = paramValue(key);
+    if (value) {
+        copiedStringCount++;
+        return *value;
     }
     return defaultValue;
 }
@@ -128,51 +404,122 @@ String Request::post(const String& key, const String& defaultValue) const {
 }
 
 bool Request::has(const String& key) const {
-    return parameters.find(key) != parameters.end();
+    return paramValue(key) != nullptr;
 }
 
 String Request::header(const String& name, const String& defaultValue) const {
-    auto it = headers.find(name);
-    if (it != headers.end()) {
-        return it->second;
+    const String* value = headerValue(name);
+    if (value) {
+        copiedStringCount++;
+        return *value;
     }
     return defaultValue;
 }
 
 bool Request::hasHeader(const String& name) const {
-    return headers.find(name) != headers.end();
+    return headerValue(name) != nullptr;
+}
+
+const String* Request::paramValue(const String& key) const {
+    // Route parameters take precedence over query and form parameters
+    for (uint8_t i = 0; i < routeParameterCount; i++) {
+        if (routeParameters[i].key == key) {
+            return &routeParameters[i].value;
+        }
+    }
+    
+    if (!serverRequest) {
+        return nullptr;
+    }
+    
+    const AsyncWebParameter* param = serverRequest->getParam(key);
+    if (!param) {
+        param = serverRequest->getParam(key, true);
+    }
+    return param ? &param->value() : nullptr;
+}
+
+const String* Request::headerValue(const String& name) const {
+    if (!serverRequest) {
+        return nullptr;
+    }
+    
+    const AsyncWebHeader* header = serverRequest->getHeader(name);
+    return header ? &header->value() : nullptr;
 }
 
 bool Request::hasFile(const String& name) const {
-    // TODO: Implement file upload support
-    return false;
+    return file(name) != nullptr;
+}
+
+const UploadedFile* Request::file(const String& name) const {
+    for (const UploadedFile& uploaded : uploadedFiles) {
+        if (uploaded.complete && uploaded.field == name) {
+            return &uploaded;
+        }
+    }
+    return nullptr;
 }
 
 bool Request::filled(const String& key) const {
-    String value = get(key);
-    return value.length() > 0;
+    const String* value = paramValue(key);
+    return value && value->length() > 0;
+}
+
+String Request::getBody() const {
+    if (rawBodyData) {
+        copiedStringCount++;
+        return String(rawBodyData, rawBodyLength);
+    }
+    return body;
+}
+
+void Request::setBody(const String& content) {
+    body = content;
+    rawBodyData = nullptr;
+    rawBodyLength = 0;
+    jsonBody.reset();
 }
 
-JsonDocument Request::json() const {
-    JsonDocument doc;
-    if (body.length() > 0) {
-        DeserializationError error = deserializeJson(doc, body);
+const JsonDocument& Request::json() const {
+    if (jsonBody) {
+        return *jsonBody;
+    }
+    
+    // Large payloads are parsed into PSRAM
+    if (bodyLength() >= psramBodyThreshold && psramFound()) {
+        jsonBody.reset(new JsonDocument(PsramAllocator::instance()));
+    } else {
+        jsonBody.reset(new JsonDocument());
+    }
+    
+    if (bodyLength() > 0) {
+        DeserializationError error = deserializeJson(*jsonBody, bodyData(), bodyLength());
         if (error) {
             Serial.print("Failed to parse JSON body: ");
             Serial.println(error.c_str());
-            Serial.print("Body content: ");
-            Serial.println(body);
         }
     }
-    return doc;
+    return *jsonBody;
+}
+
+bool Request::isJson() const {
+    const char* data = bodyData();
+    size_t length = bodyLength();
+    
+    size_t i = 0;
+    while (i < length && isspace((unsigned char)data[i])) {
+        i++;
+    }
+    return i < length && (data[i] == '{' || data[i] == '[');
 }
 
 bool Request::wantsJson() const {
-    String accept = header("Accept");
-    String contentType = header("Content-Type");
+    const String* accept = headerValue("Accept");
+    const String* contentType = headerValue("Content-Type");
     
-    return accept.indexOf("application/json") >= 0 || 
-           contentType.indexOf("application/json") >= 0;
+    return (accept && accept->indexOf("application/json") >= 0) || 
+           (contentType && contentType->indexOf("application/json") >= 0);
 }
 
 String Request::ip() const {
@@ -180,12 +527,41 @@ String Request::ip() const {
     return serverRequest->client()->remoteIP().toString();
 }
 
+uint32_t Request::ipAddress() const {
+    uint32_t address = serverRequest ? (uint32_t)serverRequest->client()->remoteIP() : 0;
+    // 0 is reserved as "no address" by address-keyed tables
+    return address != 0 ? address : 0xffffffff;
+}
+
 String Request::userAgent() const {
     return header("User-Agent");
 }
 
+const TokenClaims* Request::auth() const {
+    if (authState < 0) {
+        const String* authorization = headerValue("Authorization");
+        authState = authorization && authorization->startsWith("Bearer ") &&
+                    AuthToken::verify(authorization->substring(7), authClaims) ? 1 : 0;
+    }
+    return authState == 1 ? &authClaims : nullptr;
+}
+
 void Request::setRouteParameter(const String& key, const String& value) {
-    parameters[key] = value;
+    for (uint8_t i = 0; i < routeParameterCount; i++) {
+        if (routeParameters[i].key == key) {
+            routeParameters[i].value = value;
+            return;
+        }
+    }
+    
+    if (routeParameterCount >= REQUEST_MAX_ROUTE_PARAMS) {
+        Serial.println("[Request] Too many route parameters, dropping: " + key);
+        return;
+    }
+    
+    routeParameters[routeParameterCount].key = key;
+    routeParameters[routeParameterCount].value = value;
+    routeParameterCount++;
 }
 
 String Request::route(const String& key, const String& defaultValue) const {
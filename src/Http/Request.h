@@ -4,14 +4,56 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include "ESPAsyncWebServer.h"
+#include <FS.h>
 #include <map>
+#include <memory>
+#include <vector>
+#include "HttpMethod.h"
+#include "AuthToken.h"
+
+struct Route;
+
+// Maximum number of route parameters stored inline in a Request
+#ifndef REQUEST_MAX_ROUTE_PARAMS
+#define REQUEST_MAX_ROUTE_PARAMS 8
+#endif
+
+// File received from a multipart/form-data upload and written to storage
+struct UploadedFile {
+    String field;
+    String filename;
+    String path;        // Where the content is; a temporary name until the response is sent
+    String destination; // Upload directory path it is moved to when the handler answers 2xx
+    size_t size = 0;
+    unsigned long durationMs = 0;
+    bool complete = false;
+    
+    uint32_t bytesPerSecond() const { return durationMs > 0 ? (uint64_t)size * 1000 / durationMs : size; }
+};
 
 class Request {
 private:
+    struct RouteParameter {
+        String key;
+        String value;
+    };
+    
     AsyncWebServerRequest* serverRequest;
-    std::map<String, String> parameters;
-    std::map<String, String> headers;
+    HttpMethod requestMethod;
+    RouteParameter routeParameters[REQUEST_MAX_ROUTE_PARAMS];
+    uint8_t routeParameterCount = 0;
     String body;
+    const char* rawBodyData = nullptr; // Points into the body handler's buffer or body parameter
+    size_t rawBodyLength = 0;
+    mutable uint16_t copiedStringCount = 0;
+    mutable std::unique_ptr<JsonDocument> jsonBody; // Parsed on first json() call
+    std::vector<UploadedFile> uploadedFiles;
+    const Route* matched = nullptr;
+    mutable TokenClaims authClaims;
+    mutable int8_t authState = -1; // -1 unchecked, 0 invalid, 1 verified
+    
+    static size_t maxBodySize;
+    static size_t psramBodyThreshold;
 
 public:
     Request(AsyncWebServerRequest* request);
@@ -19,13 +61,34 @@ public:
     // Static method to set up body handling
     static void setupBodyHandling(AsyncWebServer* server);
     
+    // Body limits; bodies at or above the threshold are buffered in PSRAM when present
+    static void setMaxBodySize(size_t bytes) { maxBodySize = bytes; }
+    static size_t getMaxBodySize() { return maxBodySize; }
+    static void setPsramBodyThreshold(size_t bytes) { psramBodyThreshold = bytes; }
+    static size_t getPsramBodyThreshold() { return psramBodyThreshold; }
+    
+    // Stream multipart file parts straight to storage; disabled until called
+    static void enableUploads(FS& storage, const String& directory = "/uploads", size_t maxSize = 1048576);
+    static void disableUploads();
+    
+    // HTTP status (413/500/503/507) if the body or upload handler refused the request, otherwise 0
+    static int bodyError(AsyncWebServerRequest* request);
+    
+    // Runs callback when the server frees request. AsyncWebServerRequest keeps a single
+    // disconnect handler, so everything that needs one registers here instead.
+    static void onDisconnect(AsyncWebServerRequest* request, std::function<void()> callback);
+    
     // HTTP Methods
-    String method() const;
-    bool isGet() const { return method() == "GET"; }
-    bool isPost() const { return method() == "POST"; }
-    bool isPut() const { return method() == "PUT"; }
-    bool isDelete() const { return method() == "DELETE"; }
-    bool isPatch() const { return method() == "PATCH"; }
+    String method() const { return httpMethodName(requestMethod); }
+    HttpMethod httpMethod() const { return requestMethod; }
+    bool is(uint8_t methods) const { return (requestMethod & methods) != 0; }
+    bool isGet() const { return requestMethod == METHOD_GET; }
+    bool isPost() const { return requestMethod == METHOD_POST; }
+    bool isPut() const { return requestMethod == METHOD_PUT; }
+    bool isDelete() const { return requestMethod == METHOD_DELETE; }
+    bool isPatch() const { return requestMethod == METHOD_PATCH; }
+    bool isHead() const { return requestMethod == METHOD_HEAD; }
+    bool isOptions() const { return requestMethod == METHOD_OPTIONS; }
     
     // URL and Path
     String url() const;
@@ -43,29 +106,53 @@ public:
     bool hasHeader(const String& name) const;
     
     // Body
-    String getBody() const { return body; }
-    void setBody(const String& content) { body = content; }
+    String getBody() const;
+    void setBody(const String& content);
+    const char* bodyData() const { return rawBodyData ? rawBodyData : body.c_str(); }
+    size_t bodyLength() const { return rawBodyData ? rawBodyLength : body.length(); }
     
-    // Files (for future implementation)
+    // Files uploaded with this request
     bool hasFile(const String& name) const;
+    const UploadedFile* file(const String& name) const;
+    const std::vector<UploadedFile>& files() const { return uploadedFiles; }
+    
+    // Moves uploaded files still at their temporary path into place after a 2xx response, otherwise deletes them
+    void finishUploads(int statusCode);
     
     // Validation helpers
     bool filled(const String& key) const;
     bool missing(const String& key) const { return !has(key); }
     
-    // JSON support
-    JsonDocument json() const;
+    // JSON support; the body is parsed once and the document reused
+    const JsonDocument& json() const;
+    bool isJson() const;
     bool wantsJson() const;
     
     // Client info
     String ip() const;
+    uint32_t ipAddress() const; // IPv4 address in binary form, never 0
     String userAgent() const;
     
+    // Claims of a valid "Authorization: Bearer" token, verified on first call; nullptr otherwise
+    const TokenClaims* auth() const;
+    
     // Route parameters (set by router)
     void setRouteParameter(const String& key, const String& value);
     String route(const String& key, const String& defaultValue = "") const;
     
+    // Route being dispatched, so middleware can read its options; nullptr outside the router
+    void setMatchedRoute(const Route* route) { matched = route; }
+    const Route* matchedRoute() const { return matched; }
+    
     AsyncWebServerRequest* getServerRequest() const { return serverRequest; }
+    
+    // Header, parameter and body values copied into new Strings by the accessors so far
+    uint16_t copiedStrings() const { return copiedStringCount; }
+    
+private:
+    // Non-copying lookups; returned pointers live as long as the server request
+    const String* paramValue(const String& key) const;
+    const String* headerValue(const String& name) const;
 };
 
 #endif
@@ -1,77 +1,287 @@
 #include "Response.h"
+#include "StaticFileCache.h"
+#include "GzipEncoder.h"
+
+struct MimeType {
+    const char* extension;
+    const char* type;
+};
+
+// Sorted by extension for binary search
+static constexpr MimeType mimeTypes[] = {
+    {"css", "text/css"},
+    {"csv", "text/csv"},
+    {"gif", "image/gif"},
+    {"htm", "text/html"},
+    {"html", "text/html"},
+    {"ico", "image/x-icon"},
+    {"jpeg", "image/jpeg"},
+    {"jpg", "image/jpeg"},
+    {"js", "application/javascript"},
+    {"json", "application/json"},
+    {"pdf", "application/pdf"},
+    {"png", "image/png"},
+    {"svg", "image/svg+xml"},
+    {"txt", "text/plain"},
+    {"webp", "image/webp"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"xml", "application/xml"},
+};
+
+static constexpr size_t mimeTypeCount = sizeof(mimeTypes) / sizeof(mimeTypes[0]);
+
+static constexpr char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+// Compares the first length characters of extension (any case) against a lowercase table key
+static constexpr int compareExtension(const char* extension, size_t length, const char* key) {
+    for (size_t i = 0; i < length; i++) {
+        char c = lowerAscii(extension[i]);
+        if (key[i] == '\0' || c > key[i]) return 1;
+        if (c < key[i]) return -1;
+    }
+    return key[length] == '\0' ? 0 : -1;
+}
+
+static constexpr bool mimeTypesSorted() {
+    for (size_t i = 1; i < mimeTypeCount; i++) {
+        const char* previous = mimeTypes[i - 1].extension;
+        size_t length = 0;
+        while (previous[length] != '\0') length++;
+        if (compareExtension(previous, length, mimeTypes[i].extension) >= 0) return false;
+    }
+    return true;
+}
+
+static_assert(mimeTypesSorted(), "mimeTypes must be sorted by extension");
+
+static const char* mimeTypeFor(const String& path) {
+    const char* begin = path.c_str();
+    const char* extension = nullptr;
+    for (const char* c = begin; *c != '\0'; c++) {
+        if (*c == '.') extension = c + 1;
+        else if (*c == '/') extension = nullptr;
+    }
+    
+    if (extension) {
+        size_t length = path.length() - (extension - begin);
+        size_t low = 0;
+        size_t high = mimeTypeCount;
+        while (low < high) {
+            size_t middle = (low + high) / 2;
+            int order = compareExtension(extension, length, mimeTypes[middle].extension);
+            if (order == 0) return mimeTypes[middle].type;
+            if (order < 0) high = middle;
+            else low = middle + 1;
+        }
+    }
+    return "application/octet-stream";
+}
+
+size_t Response::compressionThreshold = 0;
 
 Response::Response(AsyncWebServerRequest* req, FS& storageType) 
     : storage(storageType), request(req), statusCode(200), type("text/html"), 
       binaryData(nullptr), binaryLength(0), isBinaryResponse(false) {
 }
 
-Response& Response::status(int code) {
+Response& Response::status(int code) & {
     statusCode = code;
     return *this;
 }
 
-Response& Response::content(const String& body) {
+Response& Response::content(const String& body) & {
+    clearBody();
     this->body = body;
-    isBinaryResponse = false;
     return *this;
 }
 
-Response& Response::html(const String& html) {
+Response& Response::html(const String& html) & {
+    clearBody();
     body = html;
     type = "text/html";
-    isBinaryResponse = false;
     return *this;
 }
 
-Response& Response::text(const String& text) {
+Response& Response::text(const String& text) & {
+    clearBody();
     body = text;
     type = "text/plain";
-    isBinaryResponse = false;
     return *this;
 }
 
-Response& Response::json(const JsonDocument& data) {
-    String jsonString;
-    serializeJson(data, jsonString);
-    body = jsonString;
+Response& Response::json(const JsonDocument& data) & {
+    // Serialize once into a buffer of the exact size
+    clearBody();
+    body.reserve(measureJson(data));
+    serializeJson(data, body);
+    type = "application/json";
+    return *this;
+}
+
+Response& Response::json(JsonDocument&& data) & {
+    clearBody();
+    jsonData = std::make_unique<JsonDocument>(std::move(data));
     type = "application/json";
-    isBinaryResponse = false;
     return *this;
 }
 
-Response& Response::json(const String& jsonString) {
+Response& Response::json(const String& jsonString) & {
+    clearBody();
     body = jsonString;
     type = "application/json";
-    isBinaryResponse = false;
     return *this;
 }
 
-Response& Response::binary(const uint8_t* data, size_t length, const String& contentType) {
+Response& Response::binary(const uint8_t* data, size_t length, const String& contentType) & {
+    clearBody();
     binaryData = data;
     binaryLength = length;
     type = contentType;
     isBinaryResponse = true;
-    body = ""; // Clear text body for binary data
     return *this;
 }
 
-Response& Response::header(const String& name, const String& value) {
-    headers[name] = value;
+Response& Response::binary(const uint8_t* data, size_t length, const String& contentType, ResponseRelease release) & {
+    clearBody();
+    ownedData = std::make_shared<OwnedBinary>(data, length, std::move(release));
+    type = contentType;
     return *this;
 }
 
-Response& Response::contentType(const String& type) {
+Response& Response::stream(const String& contentType, ResponseProducer producer) & {
+    clearBody();
+    this->producer = producer;
+    type = contentType;
+    return *this;
+}
+
+void Response::clearBody() {
+    body = "";
+    jsonData.reset();
+    producer = nullptr;
+    cachedFile.reset();
+    ownedData.reset();
+    fileHandle = File();
+    ranges.clear();
+    rangeTotal = 0;
+    binaryData = nullptr;
+    binaryLength = 0;
+    isBinaryResponse = false;
+}
+
+// Header names that header() stores as pointers instead of String copies
+static const char* const commonHeaderNames[] = {
+    "Accept-Ranges",
+    "Access-Control-Allow-Headers",
+    "Access-Control-Allow-Methods",
+    "Access-Control-Allow-Origin",
+    "Access-Control-Max-Age",
+    "Allow",
+    "Cache-Control",
+    "Content-Disposition",
+    "Content-Encoding",
+    "Content-Range",
+    "ETag",
+    "Last-Modified",
+    "Location",
+    "Retry-After",
+    "Vary",
+};
+
+static const char* internHeaderName(const char* name) {
+    for (const char* common : commonHeaderNames) {
+        if (strcasecmp(common, name) == 0) return common;
+    }
+    return nullptr;
+}
+
+ResponseHeader& Response::headerAt(size_t index) {
+    return index < RESPONSE_INLINE_HEADERS ? inlineHeaders[index] : extraHeaders[index - RESPONSE_INLINE_HEADERS];
+}
+
+const ResponseHeader& Response::headerAt(size_t index) const {
+    return index < RESPONSE_INLINE_HEADERS ? inlineHeaders[index] : extraHeaders[index - RESPONSE_INLINE_HEADERS];
+}
+
+ResponseHeader* Response::findHeader(const char* name) {
+    for (size_t i = 0; i < headerCount; i++) {
+        ResponseHeader& entry = headerAt(i);
+        if (strcasecmp(entry.getName(), name) == 0) return &entry;
+    }
+    return nullptr;
+}
+
+const String* Response::getHeader(const char* name) const {
+    for (size_t i = 0; i < headerCount; i++) {
+        const ResponseHeader& entry = headerAt(i);
+        if (strcasecmp(entry.getName(), name) == 0) return &entry.value;
+    }
+    return nullptr;
+}
+
+void Response::setHeader(const char* name, const String* customName, const String& value) {
+    ResponseHeader* entry = findHeader(name);
+    if (!entry) {
+        if (headerCount >= RESPONSE_INLINE_HEADERS) {
+            extraHeaders.emplace_back();
+        }
+        entry = &headerAt(headerCount++);
+        entry->name = internHeaderName(name);
+        if (!entry->name) {
+            entry->customName = customName ? *customName : String(name);
+        }
+    }
+    entry->value = value;
+}
+
+void Response::removeHeader(const char* name) {
+    for (size_t i = 0; i < headerCount; i++) {
+        if (strcasecmp(headerAt(i).getName(), name) != 0) continue;
+        
+        // Shift the rest down to keep insertion order
+        for (size_t j = i + 1; j < headerCount; j++) {
+            headerAt(j - 1) = std::move(headerAt(j));
+        }
+        headerCount--;
+        if (headerCount >= RESPONSE_INLINE_HEADERS) {
+            extraHeaders.pop_back();
+        } else {
+            headerAt(headerCount) = ResponseHeader();
+        }
+        return;
+    }
+}
+
+Response& Response::compress(bool enabled) & {
+    compressionAllowed = enabled;
+    return *this;
+}
+
+Response& Response::header(const char* name, const String& value) & {
+    setHeader(name, nullptr, value);
+    return *this;
+}
+
+Response& Response::header(const String& name, const String& value) & {
+    setHeader(name.c_str(), &name, value);
+    return *this;
+}
+
+Response& Response::contentType(const String& type) & {
     this->type = type;
     return *this;
 }
 
-Response& Response::redirect(const String& url, int code) {
+Response& Response::redirect(const String& url, int code) & {
     statusCode = code;
     header("Location", url);
     return *this;
 }
 
-Response& Response::back() {
+Response& Response::back() & {
     // Get referer header and redirect there, or to home
     String referer = "";
     if (request->hasHeader("Referer")) {
@@ -83,110 +293,393 @@ Response& Response::back() {
     return redirect(referer);
 }
 
-Response& Response::view(const String& template_name, const JsonDocument& data) {
+Response& Response::view(const String& template_name, const JsonDocument& data) & {
     // TODO: Implement view rendering
     // For now, return simple HTML
+    clearBody();
     body = "<html><body><h1>View: " + template_name + "</h1></body></html>";
     type = "text/html";
     return *this;
 }
 
-Response& Response::file(const String& path) {
-    // Check if file exists in storage
-    if (!storage.exists(path)) {
+Response& Response::file(const String& path) & {
+    StaticFileCache* cache = StaticFileCache::getInstance();
+    
+    // Prefer a precompressed .gz sidecar when the client accepts gzip
+    String servedPath = path;
+    if (!path.endsWith(".gz")) {
+        const FileVariants& variants = cache->variantsFor(storage, path);
+        if (variants.gzip) {
+            header("Vary", "Accept-Encoding");
+            if (acceptsGzip() || !variants.plain) {
+                servedPath = path + ".gz";
+                header("Content-Encoding", "gzip");
+            }
+        }
+    }
+    
+    clearBody();
+    
+    // Validators are cached per path, so a fresh entry answers without opening the file
+    File handle;
+    const FileValidators* validators = cache->validatorsFor(storage, servedPath, &handle);
+    if (!validators) {
         statusCode = 404;
         body = "File not found";
         type = "text/plain";
         return *this;
     }
     
-    // Open file
-    File file = storage.open(path, "r");
-    if (!file) {
+    String cacheControl = cache->cachePolicyFor(path);
+    if (cacheControl.length() > 0) {
+        header("Cache-Control", cacheControl);
+    }
+    header("ETag", validators->etag);
+    if (validators->lastModified.length() > 0) {
+        header("Last-Modified", validators->lastModified);
+    }
+    
+    if (notModified(validators->etag, validators->lastModified)) {
+        statusCode = 304;
+        removeHeader("Content-Encoding");
+        return *this;
+    }
+    
+    type = mimeTypeFor(path);
+    header("Accept-Ranges", "bytes");
+    
+    if (!selectRanges(*validators)) {
+        statusCode = 416;
+        header("Content-Range", "bytes */" + String(validators->size));
+        removeHeader("Content-Encoding");
+        return *this;
+    }
+    if (!ranges.empty()) {
+        statusCode = 206;
+    }
+    
+    // Hot files are served from PSRAM when the content cache is enabled
+    cachedFile = cache->content(storage, servedPath, *validators, &handle);
+    if (cachedFile) {
+        return *this;
+    }
+    
+    // Keep the handle so send() streams from the file opened here
+    if (!handle) {
+        handle = storage.open(servedPath, "r");
+    }
+    if (!handle) {
         statusCode = 500;
         body = "Unable to open file";
         type = "text/plain";
         return *this;
     }
+    fileHandle = handle;
+    
+    return *this;
+}
+
+bool Response::acceptsGzip() const {
+    if (!request) return false;
+    const AsyncWebHeader* acceptEncoding = request->getHeader("Accept-Encoding");
+    return acceptEncoding && acceptEncoding->value().indexOf("gzip") >= 0;
+}
+
+bool Response::notModified(const String& etag, const String& lastModified) const {
+    if (!request) return false;
     
-    // Determine content type based on file extension
-    String contentType = "application/octet-stream"; // Default binary type
-    String lowerPath = path;
-    lowerPath.toLowerCase();
-    
-    if (lowerPath.endsWith(".html") || lowerPath.endsWith(".htm")) {
-        contentType = "text/html";
-    } else if (lowerPath.endsWith(".css")) {
-        contentType = "text/css";
-    } else if (lowerPath.endsWith(".js")) {
-        contentType = "application/javascript";
-    } else if (lowerPath.endsWith(".json")) {
-        contentType = "application/json";
-    } else if (lowerPath.endsWith(".txt")) {
-        contentType = "text/plain";
-    } else if (lowerPath.endsWith(".ico")) {
-        contentType = "image/x-icon";
-    } else if (lowerPath.endsWith(".png")) {
-        contentType = "image/png";
-    } else if (lowerPath.endsWith(".jpg") || lowerPath.endsWith(".jpeg")) {
-        contentType = "image/jpeg";
-    } else if (lowerPath.endsWith(".gif")) {
-        contentType = "image/gif";
-    } else if (lowerPath.endsWith(".svg")) {
-        contentType = "image/svg+xml";
-    } else if (lowerPath.endsWith(".pdf")) {
-        contentType = "application/pdf";
+    // If-None-Match takes precedence over If-Modified-Since
+    const AsyncWebHeader* ifNoneMatch = request->getHeader("If-None-Match");
+    if (ifNoneMatch) {
+        const String& tags = ifNoneMatch->value();
+        return tags == "*" || tags.indexOf(etag) >= 0;
     }
     
-    type = contentType;
+    // Clients echo Last-Modified back verbatim, so an exact match means unchanged
+    const AsyncWebHeader* ifModifiedSince = request->getHeader("If-Modified-Since");
+    return ifModifiedSince && lastModified.length() > 0 &&
+           ifModifiedSince->value() == lastModified;
+}
+
+bool Response::selectRanges(const FileValidators& validators) {
+    ranges.clear();
+    rangeTotal = validators.size;
+    if (!request) return true;
     
-    // For binary files, we need to handle them differently
-    // Store the file path for later use in send() method
-    body = ""; // Clear body for binary files
-    header("X-File-Path", path); // Store path in custom header for send() method
+    const AsyncWebHeader* rangeHeader = request->getHeader("Range");
+    if (!rangeHeader) return true;
     
-    file.close();
-    return *this;
+    const AsyncWebHeader* ifRange = request->getHeader("If-Range");
+    if (ifRange && !ByteRangeParser::ifRangeMatches(ifRange->value(), validators.etag, validators.lastModified)) {
+        return true;
+    }
+    
+    return ByteRangeParser::select(rangeHeader->value(), validators.size, ranges) != RANGE_UNSATISFIABLE;
 }
 
-Response& Response::download(const String& path, const String& name) {
+// Copies whatever part of data lies at position into buffer, then moves partStart past it
+static void copyRangePart(const uint8_t* data, size_t length, size_t& partStart, size_t& position,
+                          uint8_t* buffer, size_t& written, size_t maxLen) {
+    if (written < maxLen && position >= partStart && position < partStart + length) {
+        size_t offset = position - partStart;
+        size_t count = std::min(length - offset, maxLen - written);
+        memcpy(buffer + written, data + offset, count);
+        written += count;
+        position += count;
+    }
+    partStart += length;
+}
+
+AsyncWebServerResponse* Response::beginRangeResponse() {
+    // Slices come from the PSRAM copy when cached, otherwise from the open handle
+    std::shared_ptr<CachedFile> content = cachedFile;
+    File file = fileHandle;
+    auto read = [content, file](size_t offset, uint8_t* buffer, size_t length) mutable -> size_t {
+        if (content) {
+            memcpy(buffer, content->data + offset, length);
+            return length;
+        }
+        file.seek(offset);
+        return file.read(buffer, length);
+    };
+    
+    if (ranges.size() == 1) {
+        size_t start = ranges[0].start;
+        size_t length = ranges[0].end - start + 1;
+        AsyncWebServerResponse* response = request->beginResponse(type, length,
+            [read, start, length](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+                return read(start + index, buffer, std::min(maxLen, length - index));
+            });
+        response->addHeader("Content-Range", "bytes " + String(start) + "-" + String(ranges[0].end) + "/" + String(rangeTotal));
+        return response;
+    }
+    
+    // multipart/byteranges: each part is a short header followed by its slice
+    struct Part {
+        String head;
+        size_t start;
+        size_t length;
+    };
+    String boundary = "byteranges_" + String(millis(), HEX);
+    auto parts = std::make_shared<std::vector<Part>>();
+    size_t total = 0;
+    for (const ByteRange& range : ranges) {
+        Part part;
+        part.head = "\r\n--" + boundary + "\r\nContent-Type: " + type +
+                    "\r\nContent-Range: bytes " + String(range.start) + "-" + String(range.end) +
+                    "/" + String(rangeTotal) + "\r\n\r\n";
+        part.start = range.start;
+        part.length = range.end - range.start + 1;
+        total += part.head.length() + part.length;
+        parts->push_back(part);
+    }
+    String tail = "\r\n--" + boundary + "--\r\n";
+    total += tail.length();
+    
+    return request->beginResponse("multipart/byteranges; boundary=" + boundary, total,
+        [read, parts, tail](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+            size_t written = 0;
+            size_t position = index;
+            size_t partStart = 0;
+            for (const Part& part : *parts) {
+                copyRangePart((const uint8_t*)part.head.c_str(), part.head.length(), partStart, position, buffer, written, maxLen);
+                
+                if (written < maxLen && position >= partStart && position < partStart + part.length) {
+                    size_t offset = position - partStart;
+                    size_t count = std::min(part.length - offset, maxLen - written);
+                    size_t got = read(part.start + offset, buffer + written, count);
+                    written += got;
+                    position += got;
+                    if (got < count) return written;
+                }
+                partStart += part.length;
+            }
+            copyRangePart((const uint8_t*)tail.c_str(), tail.length(), partStart, position, buffer, written, maxLen);
+            return written;
+        });
+}
+
+Response& Response::asset(const EmbeddedAsset& asset) & {
+    clearBody();
+    
+    String etag = asset.etag;
+    header("ETag", etag);
+    header("Cache-Control", asset.immutable ? "public, max-age=31536000, immutable" : "no-cache");
+    if (notModified(etag, "")) {
+        statusCode = 304;
+        return *this;
+    }
+    
+    // Embedded assets only exist compressed; practically every browser accepts gzip
+    if (asset.gzipped) {
+        header("Content-Encoding", "gzip");
+    }
+    return binary(asset.data, asset.length, asset.contentType);
+}
+
+static bool isCompressibleType(const String& type) {
+    return type.startsWith("text/") || type.startsWith("application/json") ||
+           type.startsWith("application/javascript") || type.startsWith("application/xml") ||
+           type.startsWith("image/svg+xml");
+}
+
+bool Response::shouldCompress() {
+    if (!compressionAllowed || compressionThreshold == 0) return false;
+    if (isBinaryResponse || ownedData || producer || cachedFile || fileHandle || !ranges.empty()) return false;
+    if (statusCode < 200 || statusCode == 204 || statusCode == 304) return false;
+    if (getHeader("Content-Encoding") || !isCompressibleType(type)) return false;
+    
+    size_t size = jsonData ? measureJson(*jsonData) : body.length();
+    if (size < compressionThreshold) return false;
+    
+    // The representation now depends on Accept-Encoding, even for clients that get it raw
+    header("Vary", "Accept-Encoding");
+    return acceptsGzip();
+}
+
+AsyncWebServerResponse* Response::beginCompressedResponse() {
+    // The payload moves into the filler so it outlives the encoder reading from it
+    std::shared_ptr<String> payload = std::make_shared<String>(std::move(body));
+    if (jsonData) {
+        payload->reserve(measureJson(*jsonData));
+        serializeJson(*jsonData, *payload);
+        jsonData.reset();
+    }
+    
+    std::shared_ptr<GzipEncoder> encoder = std::make_shared<GzipEncoder>((const uint8_t*)payload->c_str(), payload->length());
+    if (!encoder->isValid()) {
+        // Not enough memory for the match tables; send it uncompressed
+        body = std::move(*payload);
+        return nullptr;
+    }
+    
+    AsyncWebServerResponse* response = request->beginChunkedResponse(type,
+        [payload, encoder](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return encoder->read(buffer, maxLen);
+        });
+    response->setCode(statusCode);
+    response->addHeader("Content-Encoding", "gzip");
+    return response;
+}
+
+Response& Response::download(const String& path, const String& name) & {
     String filename = name.length() > 0 ? name : path;
     header("Content-Disposition", "attachment; filename=\"" + filename + "\"");
     return file(path);
 }
 
+String Response::getContent() const {
+    if (jsonData) {
+        String content;
+        content.reserve(measureJson(*jsonData));
+        serializeJson(*jsonData, content);
+        return content;
+    }
+    return body;
+}
+
+bool Response::isBuffered() const {
+    return !producer && !cachedFile && !ownedData && !fileHandle && ranges.empty() && !isBinaryResponse;
+}
+
+bool Response::isReplicable() const {
+    // A raw binary() pointer is only valid for the request that produced it
+    return !producer && !fileHandle && ranges.empty() && (!isBinaryResponse || ownedData);
+}
+
+Response Response::replicate(AsyncWebServerRequest* other) const {
+    Response copy(other, storage);
+    copy.statusCode = statusCode;
+    copy.type = type;
+    copy.body = jsonData ? getContent() : body;
+    copy.cachedFile = cachedFile;
+    copy.ownedData = ownedData;
+    copy.binaryData = binaryData;
+    copy.binaryLength = binaryLength;
+    copy.isBinaryResponse = isBinaryResponse;
+    copy.compressionAllowed = compressionAllowed;
+    
+    for (size_t i = 0; i < headerCount; i++) {
+        const ResponseHeader& entry = headerAt(i);
+        copy.setHeader(entry.getName(), entry.name ? nullptr : &entry.customName, entry.value);
+    }
+    return copy;
+}
+
 void Response::send() {
     if (!request) return;
     
-    AsyncWebServerResponse* response;
+    AsyncWebServerResponse* response = nullptr;
     
+    // Text payloads over the compression threshold are gzipped while they are sent
+    if (shouldCompress()) {
+        response = beginCompressedResponse();
+    }
+    
+    if (response) {
+        // Built by the compression stage
+    }
     // Check if this is a binary response
-    if (isBinaryResponse && binaryData && binaryLength > 0) {
+    else if (isBinaryResponse && binaryData && binaryLength > 0) {
         // Send binary data
         response = request->beginResponse_P(statusCode, type, binaryData, binaryLength);
     }
-    // Check if this is a file response
-    else if (headers.find("X-File-Path") != headers.end()) {
-        String filePath = headers["X-File-Path"];
-        
-        // Remove the custom header before sending
-        headers.erase("X-File-Path");
-        
-        // Serve file directly from storage
-        response = request->beginResponse(storage, filePath, type);
-        
-        if (!response) {
-            // Fallback if file serving fails
-            response = request->beginResponse(404, "text/plain", "File not found");
-        }
+    // Owned buffer sent in place; released as soon as the last byte is queued
+    else if (ownedData) {
+        std::shared_ptr<OwnedBinary> owned = std::move(ownedData);
+        response = request->beginResponse(type, owned->length, [owned](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            if (!owned->data) return 0;
+            size_t length = std::min(maxLen, owned->length - index);
+            memcpy(buffer, owned->data + index, length);
+            // Replicas still sending keep the buffer; the last holder releases it
+            if (index + length >= owned->length && owned.use_count() == 1) {
+                owned->release();
+            }
+            return length;
+        });
+        response->setCode(statusCode);
+    }
+    // Partial content slices of a cached or opened file
+    else if (!ranges.empty()) {
+        response = beginRangeResponse();
+        response->setCode(statusCode);
+        fileHandle = File();
+    }
+    // File content resident in the PSRAM cache; the filler keeps the buffer alive until sent
+    else if (cachedFile) {
+        std::shared_ptr<CachedFile> content = cachedFile;
+        response = request->beginResponse(type, content->size, [content](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            size_t length = std::min(maxLen, content->size - index);
+            memcpy(buffer, content->data + index, length);
+            return length;
+        });
+        response->setCode(statusCode);
+    }
+    // File opened in file(); the server reads it as the TCP buffer drains
+    else if (fileHandle) {
+        response = request->beginResponse(fileHandle, fileHandle.path(), type);
+        response->setCode(statusCode);
+        fileHandle = File();
+    } else if (producer) {
+        // Chunked transfer; the producer is called as the TCP send buffer drains
+        response = request->beginChunkedResponse(type, producer);
+        response->setCode(statusCode);
+    } else if (jsonData) {
+        // Serialize the held document directly into the response buffer
+        AsyncResponseStream* stream = request->beginResponseStream(type);
+        stream->setCode(statusCode);
+        serializeJson(*jsonData, *stream);
+        jsonData.reset();
+        response = stream;
     } else {
         // Regular text/json response
         response = request->beginResponse(statusCode, type, body);
     }
     
     // Add custom headers
-    for (const auto& pair : headers) {
-        response->addHeader(pair.first, pair.second);
+    for (size_t i = 0; i < headerCount; i++) {
+        const ResponseHeader& entry = headerAt(i);
+        response->addHeader(entry.getName(), entry.value);
     }
     
     request->send(response);
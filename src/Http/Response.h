@@ -5,9 +5,62 @@
 #include <SPIFFS.h>
 #include <LittleFS.h>
 #include <map>
+#include <memory>
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
+#include <functional>
+#include <vector>
+#include "EmbeddedAsset.h"
+#include "ByteRange.h"
 
+// Headers stored inline before spilling to the heap
+#ifndef RESPONSE_INLINE_HEADERS
+#define RESPONSE_INLINE_HEADERS 6
+#endif
+
+// Fills at most maxLen bytes of the payload starting at index; returns 0 once the payload is complete
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> ResponseProducer;
+
+// Called once an owned binary payload is no longer needed
+typedef std::function<void()> ResponseRelease;
+
+// Buffer owned by a response; release runs after the last byte is handed to the connection,
+// or when the response is dropped or the client disconnects before that. When the buffer is
+// shared by replicated responses it is released once the last of them is done with it.
+struct OwnedBinary {
+    const uint8_t* data;
+    size_t length;
+    ResponseRelease onRelease;
+    
+    OwnedBinary(const uint8_t* data, size_t length, ResponseRelease onRelease)
+        : data(data), length(length), onRelease(std::move(onRelease)) {}
+    ~OwnedBinary() { release(); }
+    
+    void release() {
+        if (onRelease) {
+            ResponseRelease callback = std::move(onRelease);
+            onRelease = nullptr;
+            data = nullptr;
+            callback();
+        }
+    }
+};
+
+struct FileValidators;
+struct CachedFile;
+
+// Header stored by Response; common names point into a static table instead of owning a copy
+struct ResponseHeader {
+    const char* name = nullptr; // Interned name, or nullptr when customName is used
+    String customName;
+    String value;
+    
+    const char* getName() const { return name ? name : customName.c_str(); }
+};
+
+// Move-only: the body, document, producer and file handle have a single owner on their way
+// from the handler through the middleware to send(). Builder methods called on a temporary
+// return Response&& so `return Response(req).status(200).json(doc);` moves instead of copying.
 class Response {
 private:
     AsyncWebServerRequest* request;
@@ -15,55 +68,164 @@ private:
     String body;
     String type;
     int statusCode;
-    std::map<String, String> headers;
+    
+    // Headers beyond RESPONSE_INLINE_HEADERS spill into extraHeaders
+    ResponseHeader inlineHeaders[RESPONSE_INLINE_HEADERS];
+    size_t headerCount = 0;
+    std::vector<ResponseHeader> extraHeaders;
+    
+    // Document held until send() and serialized straight into the response stream
+    std::unique_ptr<JsonDocument> jsonData;
+    
+    // Chunked payload generated on demand while sending
+    ResponseProducer producer;
+    
+    // File content served from the PSRAM cache
+    std::shared_ptr<CachedFile> cachedFile;
+    
+    // File opened by file() and handed to the server in send()
+    File fileHandle;
+    
+    // Ranges selected by a Range header, and the full size of the file they slice
+    std::vector<ByteRange> ranges;
+    size_t rangeTotal = 0;
+    
+    // Cleared by compress(false) or routes registered with uncompressed()
+    bool compressionAllowed = true;
+    static size_t compressionThreshold;
+    
+    // Binary payload owned until it has been sent
+    std::shared_ptr<OwnedBinary> ownedData;
     
     // Binary data support
     const uint8_t* binaryData;
     size_t binaryLength;
     bool isBinaryResponse;
+    
+    void clearBody();
+    ResponseHeader& headerAt(size_t index);
+    const ResponseHeader& headerAt(size_t index) const;
+    ResponseHeader* findHeader(const char* name);
+    void setHeader(const char* name, const String* customName, const String& value);
+    void removeHeader(const char* name);
+    bool acceptsGzip() const;
+    bool notModified(const String& etag, const String& lastModified) const;
+    bool selectRanges(const FileValidators& validators);
+    AsyncWebServerResponse* beginRangeResponse();
+    bool shouldCompress();
+    AsyncWebServerResponse* beginCompressedResponse();
 
 public:
     Response(AsyncWebServerRequest* req, FS& storageType = LittleFS);
+    Response(Response&&) = default;
+    Response(const Response&) = delete;
+    Response& operator=(const Response&) = delete;
     
     // Status codes
-    Response& status(int code);
-    Response& ok() { return status(200); }
-    Response& created() { return status(201); }
-    Response& notFound() { return status(404); }
-    Response& unauthorized() { return status(401); }
-    Response& forbidden() { return status(403); }
-    Response& internalServerError() { return status(500); }
+    Response& status(int code) &;
+    Response& ok() & { return status(200); }
+    Response& created() & { return status(201); }
+    Response& notFound() & { return status(404); }
+    Response& unauthorized() & { return status(401); }
+    Response& forbidden() & { return status(403); }
+    Response& internalServerError() & { return status(500); }
+    Response&& status(int code) && { return std::move(status(code)); }
+    Response&& ok() && { return std::move(status(200)); }
+    Response&& created() && { return std::move(status(201)); }
+    Response&& notFound() && { return std::move(status(404)); }
+    Response&& unauthorized() && { return std::move(status(401)); }
+    Response&& forbidden() && { return std::move(status(403)); }
+    Response&& internalServerError() && { return std::move(status(500)); }
     
     // Content
-    Response& content(const String& body);
-    Response& html(const String& html);
-    Response& text(const String& text);
-    Response& json(const JsonDocument& data);
-    Response& json(const String& jsonString);
-    Response& binary(const uint8_t* data, size_t length, const String& contentType = "application/octet-stream");
+    Response& content(const String& body) &;
+    Response& html(const String& html) &;
+    Response& text(const String& text) &;
+    Response& json(const JsonDocument& data) &;
+    Response& json(JsonDocument&& data) &;
+    Response& json(const String& jsonString) &;
+    Response& binary(const uint8_t* data, size_t length, const String& contentType = "application/octet-stream") &;
+    Response& binary(const uint8_t* data, size_t length, const String& contentType, ResponseRelease release) &;
+    Response& stream(const String& contentType, ResponseProducer producer) &;
+    Response&& content(const String& body) && { return std::move(content(body)); }
+    Response&& html(const String& html) && { return std::move(this->html(html)); }
+    Response&& text(const String& text) && { return std::move(this->text(text)); }
+    Response&& json(const JsonDocument& data) && { return std::move(json(data)); }
+    Response&& json(JsonDocument&& data) && { return std::move(json(std::move(data))); }
+    Response&& json(const String& jsonString) && { return std::move(json(jsonString)); }
+    Response&& binary(const uint8_t* data, size_t length, const String& contentType = "application/octet-stream") && {
+        return std::move(binary(data, length, contentType));
+    }
+    Response&& binary(const uint8_t* data, size_t length, const String& contentType, ResponseRelease release) && {
+        return std::move(binary(data, length, contentType, std::move(release)));
+    }
+    Response&& stream(const String& contentType, ResponseProducer producer) && {
+        return std::move(stream(contentType, std::move(producer)));
+    }
     
-    // Headers
-    Response& header(const String& name, const String& value);
-    Response& contentType(const String& type);
+    // Headers; names from string literals are interned when they are common
+    Response& header(const char* name, const String& value) &;
+    Response& header(const String& name, const String& value) &;
+    Response& contentType(const String& type) &;
+    Response&& header(const char* name, const String& value) && { return std::move(header(name, value)); }
+    Response&& header(const String& name, const String& value) && { return std::move(header(name, value)); }
+    Response&& contentType(const String& type) && { return std::move(contentType(type)); }
+    
+    // Gzip this response when it qualifies (default), or always send it uncompressed
+    Response& compress(bool enabled) &;
+    Response&& compress(bool enabled) && { return std::move(compress(enabled)); }
     
     // Redirects
-    Response& redirect(const String& url, int code = 302);
-    Response& back();
+    Response& redirect(const String& url, int code = 302) &;
+    Response& back() &;
+    Response&& redirect(const String& url, int code = 302) && { return std::move(redirect(url, code)); }
+    Response&& back() && { return std::move(back()); }
     
     // Views
-    Response& view(const String& template_name, const JsonDocument& data = JsonDocument());
+    Response& view(const String& template_name, const JsonDocument& data = JsonDocument()) &;
+    Response&& view(const String& template_name, const JsonDocument& data = JsonDocument()) && {
+        return std::move(view(template_name, data));
+    }
     
     // File responses
-    Response& file(const String& path);
-    Response& download(const String& path, const String& name = "");
+    Response& file(const String& path) &;
+    Response& download(const String& path, const String& name = "") &;
+    Response&& file(const String& path) && { return std::move(file(path)); }
+    Response&& download(const String& path, const String& name = "") && { return std::move(download(path, name)); }
+    
+    // Asset compiled into the firmware, sent straight from flash
+    Response& asset(const EmbeddedAsset& asset) &;
+    Response&& asset(const EmbeddedAsset& asset) && { return std::move(this->asset(asset)); }
     
     // Send the response
     void send();
     
-    // Getters
+    // Getters; the references stay valid until the response is modified or sent
     int getStatusCode() const { return statusCode; }
-    String getContent() const { return body; }
-    String getContentType() const { return type; }
+    String getContent() const;
+    const String& getBody() const { return body; }
+    const String& getContentType() const { return type; }
+    const String* getHeader(const char* name) const;
+    size_t getHeaderCount() const { return headerCount; }
+    const ResponseHeader& getHeaderAt(size_t index) const { return headerAt(index); }
+    bool hasJsonDocument() const { return jsonData != nullptr; }
+    bool isCompressionAllowed() const { return compressionAllowed; }
+    
+    // True when the payload is a body string or JSON document rather than a file, stream or binary
+    bool isBuffered() const;
+    
+    // Copy of this response for another request; owned and cached payloads are shared, not duplicated.
+    // Streams, opened files and range responses cannot be replicated.
+    bool isReplicable() const;
+    Response replicate(AsyncWebServerRequest* other) const;
+    
+    // Owned payload shared by replicas; a template that must not pin it can hold it weakly instead
+    const std::shared_ptr<OwnedBinary>& getOwnedBinary() const { return ownedData; }
+    void setOwnedBinary(std::shared_ptr<OwnedBinary> owned) { ownedData = std::move(owned); }
+    
+    // Text and JSON bodies of at least this many bytes are gzipped for clients that accept it; 0 disables
+    static void setCompressionThreshold(size_t bytes) { compressionThreshold = bytes; }
+    static size_t getCompressionThreshold() { return compressionThreshold; }
 };
 
 #endif
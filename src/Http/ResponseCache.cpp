@@ -0,0 +1,165 @@
+#include "ResponseCache.h"
+#include "Request.h"
+#include "Response.h"
+
+ResponseCache* ResponseCache::instance = nullptr;
+
+ResponseCache* ResponseCache::getInstance() {
+    if (instance == nullptr) {
+        instance = new ResponseCache();
+    }
+    return instance;
+}
+
+void ResponseCache::setBudget(size_t bytes) {
+    budget = bytes;
+    while (!order.empty() && this->bytes > budget) {
+        drop(entries.find(order.back()));
+        evictions++;
+    }
+}
+
+void ResponseCache::varyOn(const String& header) {
+    for (const String& existing : varyHeaders) {
+        if (existing.equalsIgnoreCase(header)) return;
+    }
+    varyHeaders.push_back(header);
+}
+
+String ResponseCache::keyFor(const Request& request) const {
+    String key = request.method();
+    key += ' ';
+    key += request.url();
+    
+    // Header values are separated by a byte that cannot appear in them
+    for (const String& header : varyHeaders) {
+        key += '\n';
+        key += request.header(header);
+    }
+    return key;
+}
+
+bool ResponseCache::lookup(const String& key, Response& response) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+    
+    Entry& entry = it->second;
+    unsigned long age = millis() - entry.storedAt;
+    if (age >= entry.ttl) {
+        drop(it);
+        misses++;
+        return false;
+    }
+    
+    order.splice(order.begin(), order, entry.position);
+    hits++;
+    
+    response.status(entry.statusCode).content(entry.body).contentType(entry.type).compress(entry.compress);
+    for (const auto& header : entry.headers) {
+        response.header(header.first, header.second);
+    }
+    response.header("Age", String(age / 1000));
+    return true;
+}
+
+void ResponseCache::store(const String& key, const String& path, Response& response, unsigned long ttl) {
+    if (budget == 0 || ttl == 0 || response.getStatusCode() != 200 || !response.isBuffered()) {
+        return;
+    }
+    
+    // Per-client responses must not be replayed to other clients
+    if (response.getHeader("Set-Cookie")) {
+        return;
+    }
+    
+    String body = response.getContent();
+    size_t size = sizeof(Entry) + key.length() + path.length() + body.length() + response.getContentType().length();
+    for (size_t i = 0; i < response.getHeaderCount(); i++) {
+        const ResponseHeader& header = response.getHeaderAt(i);
+        size += strlen(header.getName()) + header.value.length();
+    }
+    
+    // Serialize the document only once, whether or not it fits
+    if (response.hasJsonDocument()) {
+        response.content(body);
+    }
+    
+    // A single entry may take at most a quarter of the budget
+    if (size > budget / 4) {
+        return;
+    }
+    
+    auto existing = entries.find(key);
+    if (existing != entries.end()) {
+        drop(existing);
+    }
+    while (!order.empty() && bytes + size > budget) {
+        drop(entries.find(order.back()));
+        evictions++;
+    }
+    
+    order.push_front(key);
+    Entry& entry = entries[key];
+    entry.path = path;
+    entry.statusCode = response.getStatusCode();
+    entry.type = response.getContentType();
+    entry.body = body;
+    entry.compress = response.isCompressionAllowed();
+    entry.storedAt = millis();
+    entry.ttl = ttl;
+    entry.bytes = size;
+    entry.position = order.begin();
+    entry.headers.reserve(response.getHeaderCount());
+    for (size_t i = 0; i < response.getHeaderCount(); i++) {
+        const ResponseHeader& header = response.getHeaderAt(i);
+        entry.headers.push_back({header.getName(), header.value});
+    }
+    bytes += size;
+}
+
+void ResponseCache::drop(std::map<String, Entry>::iterator it) {
+    if (it == entries.end()) return;
+    bytes -= it->second.bytes;
+    order.erase(it->second.position);
+    entries.erase(it);
+}
+
+void ResponseCache::invalidate(const String& path) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto next = std::next(it);
+        if (it->second.path == path) {
+            drop(it);
+        }
+        it = next;
+    }
+}
+
+void ResponseCache::invalidatePrefix(const String& prefix) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto next = std::next(it);
+        if (it->second.path.startsWith(prefix)) {
+            drop(it);
+        }
+        it = next;
+    }
+}
+
+void ResponseCache::invalidateAll() {
+    entries.clear();
+    order.clear();
+    bytes = 0;
+}
+
+float ResponseCache::getHitRatio() const {
+    unsigned long total = hits + misses;
+    return total > 0 ? (float)hits / total : 0.0f;
+}
+
+void ResponseCache::resetStats() {
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
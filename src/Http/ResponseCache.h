@@ -0,0 +1,89 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <Arduino.h>
+#include <list>
+#include <map>
+#include <vector>
+
+class Request;
+class Response;
+
+// Default byte budget of the response cache; 0 disables it
+#ifndef RESPONSE_CACHE_SIZE
+#define RESPONSE_CACHE_SIZE 16384
+#endif
+
+// TTL for routes that use the "cache" middleware without Router::cache()
+#ifndef RESPONSE_CACHE_TTL
+#define RESPONSE_CACHE_TTL 5000
+#endif
+
+// Memoized GET/HEAD responses for the "cache" middleware, in a byte-bounded LRU.
+// Entries are keyed by method, URL and the values of the headers passed to varyOn(),
+// so without varyOn("Authorization") every authorized client shares the same entry.
+class ResponseCache {
+private:
+    struct Entry {
+        String path; // Without the query, for invalidate()
+        int statusCode;
+        String type;
+        String body;
+        std::vector<std::pair<String, String>> headers;
+        bool compress;
+        unsigned long storedAt;
+        unsigned long ttl;
+        size_t bytes;
+        std::list<String>::iterator position;
+    };
+    
+    static ResponseCache* instance;
+    std::map<String, Entry> entries;
+    std::list<String> order; // Most recently used first
+    std::vector<String> varyHeaders;
+    size_t budget = RESPONSE_CACHE_SIZE;
+    size_t bytes = 0;
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+    unsigned long evictions = 0;
+    
+    ResponseCache() = default;
+    
+    void drop(std::map<String, Entry>::iterator it);
+
+public:
+    static ResponseCache* getInstance();
+    
+    // Total bytes of keys, bodies and headers kept; shrinking evicts the oldest entries
+    void setBudget(size_t bytes);
+    size_t getBudget() const { return budget; }
+    bool isEnabled() const { return budget > 0; }
+    
+    // Request headers whose values are part of the cache key
+    void varyOn(const String& header);
+    
+    String keyFor(const Request& request) const;
+    
+    // Fills response from a fresh entry for key; false on a miss
+    bool lookup(const String& key, Response& response);
+    
+    // Keeps a 200 response with a buffered body for ttl ms; other responses are left alone.
+    // JSON documents are serialized once here and the response sends that copy.
+    void store(const String& key, const String& path, Response& response, unsigned long ttl);
+    
+    // Drop entries after the data behind them changed
+    void invalidate(const String& path);
+    void invalidatePrefix(const String& prefix);
+    void invalidateAll();
+    
+    // Statistics
+    unsigned long getHits() const { return hits; }
+    unsigned long getMisses() const { return misses; }
+    unsigned long getEvictions() const { return evictions; }
+    size_t getBytes() const { return bytes; }
+    size_t getEntryCount() const { return entries.size(); }
+    float getHitRatio() const;
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "StaticFileCache.h"
+#include <esp_heap_caps.h>
+#include <time.h>
+
+StaticFileCache* StaticFileCache::instance = nullptr;
+
+CachedFile::~CachedFile() {
+    free(data);
+}
+
+// Give an open handle to the caller, or close it when nobody wants it
+static void handOver(File& file, File* opened) {
+    if (opened) {
+        file.seek(0);
+        *opened = file;
+    } else {
+        file.close();
+    }
+}
+
+StaticFileCache* StaticFileCache::getInstance() {
+    if (instance == nullptr) {
+        instance = new StaticFileCache();
+    }
+    return instance;
+}
+
+const FileValidators* StaticFileCache::validatorsFor(FS& storage, const String& path, File* opened) {
+    unsigned long now = millis();
+    auto it = validators.find(path);
+    
+    // Trust recent validators without touching the filesystem
+    if (it != validators.end() && now - it->second.checkedAt < revalidateMs) {
+        return &it->second;
+    }
+    
+    File file = storage.open(path, "r");
+    if (!file || file.isDirectory()) {
+        if (it != validators.end()) {
+            validators.erase(it);
+        }
+        dropContent(path);
+        return nullptr;
+    }
+    
+    size_t size = file.size();
+    time_t lastWrite = file.getLastWrite();
+    
+    // Unchanged metadata keeps the existing ETag; otherwise hash the content again.
+    // SPIFFS reports no modification time, so there a same-size rewrite is only caught by rehashing.
+    if (it != validators.end() && it->second.size == size && lastWrite != 0 && it->second.lastWrite == lastWrite) {
+        it->second.checkedAt = now;
+        handOver(file, opened);
+        return &it->second;
+    }
+    
+    FileValidators& entry = validators[path];
+    entry.size = size;
+    entry.lastWrite = lastWrite;
+    entry.etag = computeEtag(file);
+    entry.lastModified = lastWrite > 0 ? formatHttpDate(lastWrite) : "";
+    entry.checkedAt = now;
+    handOver(file, opened);
+    
+    return &entry;
+}
+
+const FileVariants& StaticFileCache::variantsFor(FS& storage, const String& path) {
+    static const FileVariants missing;
+    unsigned long now = millis();
+    auto it = variants.find(path);
+    if (it != variants.end() && now - it->second.checkedAt < revalidateMs) {
+        return it->second;
+    }
+    
+    FileVariants found;
+    found.gzip = storage.exists(path + ".gz");
+    found.plain = storage.exists(path);
+    found.checkedAt = now;
+    
+    // Paths with nothing on flash are not remembered, so probing for missing files cannot grow the map
+    if (!found.plain && !found.gzip) {
+        if (it != variants.end()) {
+            variants.erase(it);
+        }
+        return missing;
+    }
+    FileVariants& entry = variants[path];
+    entry = found;
+    return entry;
+}
+
+void StaticFileCache::invalidate(const String& path) {
+    validators.erase(path);
+    validators.erase(path + ".gz");
+    variants.erase(path);
+    if (path.endsWith(".gz")) {
+        variants.erase(path.substring(0, path.length() - 3));
+    }
+    dropContent(path);
+    dropContent(path + ".gz");
+}
+
+void StaticFileCache::invalidateAll() {
+    validators.clear();
+    variants.clear();
+    contents.clear();
+    contentOrder.clear();
+    contentBytes = 0;
+}
+
+void StaticFileCache::setCachePolicy(const String& prefix, const String& cacheControl) {
+    for (auto& policy : cachePolicies) {
+        if (policy.first == prefix) {
+            policy.second = cacheControl;
+            return;
+        }
+    }
+    cachePolicies.push_back({prefix, cacheControl});
+}
+
+String StaticFileCache::cachePolicyFor(const String& path) const {
+    const std::pair<String, String>* best = nullptr;
+    for (const auto& policy : cachePolicies) {
+        if (path.startsWith(policy.first) && (!best || policy.first.length() > best->first.length())) {
+            best = &policy;
+        }
+    }
+    return best ? best->second : "";
+}
+
+bool StaticFileCache::enableContentCache(size_t budget, size_t maxFileSize, bool includeGzip) {
+    if (!psramFound()) {
+        Serial.println("[StaticFileCache] No PSRAM found, content cache disabled");
+        return false;
+    }
+    
+    disableContentCache();
+    contentBudget = budget;
+    contentMaxFileSize = maxFileSize > 0 ? maxFileSize : budget / 4;
+    cacheGzip = includeGzip;
+    return budget > 0;
+}
+
+void StaticFileCache::disableContentCache() {
+    contents.clear();
+    contentOrder.clear();
+    contentBytes = 0;
+    contentBudget = 0;
+}
+
+std::shared_ptr<CachedFile> StaticFileCache::content(FS& storage, const String& path, const FileValidators& validators, File* opened) {
+    if (contentBudget == 0) return nullptr;
+    if (!cacheGzip && path.endsWith(".gz")) return nullptr;
+    
+    auto it = contents.find(path);
+    if (it != contents.end()) {
+        if (it->second.file->etag == validators.etag) {
+            contentOrder.splice(contentOrder.begin(), contentOrder, it->second.position);
+            contentHits++;
+            contentBytesServed += it->second.file->size;
+            return it->second.file;
+        }
+        // Rewritten since it was loaded
+        dropContent(path);
+    }
+    
+    contentMisses++;
+    if (validators.size == 0 || validators.size > contentMaxFileSize) return nullptr;
+    
+    std::shared_ptr<CachedFile> file = loadContent(storage, path, validators, opened);
+    if (file) {
+        contentBytesServed += file->size;
+    }
+    return file;
+}
+
+std::shared_ptr<CachedFile> StaticFileCache::loadContent(FS& storage, const String& path, const FileValidators& validators, File* opened) {
+    // Make room first so the old buffers are released before allocating
+    while (!contentOrder.empty() && contentBytes + validators.size > contentBudget) {
+        String oldest = contentOrder.back();
+        dropContent(oldest);
+    }
+    
+    uint8_t* data = (uint8_t*)heap_caps_malloc(validators.size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!data) return nullptr;
+    
+    std::shared_ptr<CachedFile> file = std::make_shared<CachedFile>();
+    file->data = data;
+    file->size = validators.size;
+    file->etag = validators.etag;
+    
+    bool reuse = opened && *opened;
+    File source = reuse ? *opened : storage.open(path, "r");
+    if (!source || source.read(data, file->size) != file->size) {
+        // Leave a reused handle where the caller can still stream it from flash
+        if (reuse) source.seek(0);
+        return nullptr;
+    }
+    source.close();
+    if (reuse) *opened = File();
+    
+    contentOrder.push_front(path);
+    contents[path] = {file, contentOrder.begin()};
+    contentBytes += file->size;
+    return file;
+}
+
+void StaticFileCache::dropContent(const String& path) {
+    auto it = contents.find(path);
+    if (it == contents.end()) return;
+    
+    // Responses still sending keep their own reference to the buffer
+    contentBytes -= it->second.file->size;
+    contentOrder.erase(it->second.position);
+    contents.erase(it);
+}
+
+float StaticFileCache::getContentHitRatio() const {
+    unsigned long total = contentHits + contentMisses;
+    return total > 0 ? (float)contentHits / total : 0.0f;
+}
+
+void StaticFileCache::resetContentStats() {
+    contentHits = 0;
+    contentMisses = 0;
+    contentBytesServed = 0;
+}
+
+String StaticFileCache::computeEtag(File& file) {
+    // FNV-1a over the content, read in small blocks
+    uint32_t hash = 2166136261u;
+    uint8_t buffer[512];
+    size_t total = 0;
+    
+    file.seek(0);
+    size_t bytesRead;
+    while ((bytesRead = file.read(buffer, sizeof(buffer))) > 0) {
+        for (size_t i = 0; i < bytesRead; i++) {
+            hash ^= buffer[i];
+            hash *= 16777619u;
+        }
+        total += bytesRead;
+    }
+    
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08x-%x\"", (unsigned int)hash, (unsigned int)total);
+    return String(etag);
+}
+
+String StaticFileCache::formatHttpDate(time_t value) {
+    struct tm gmt;
+    gmtime_r(&value, &gmt);
+    
+    char date[32];
+    strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    return String(date);
+}
@@ -0,0 +1,107 @@
+#ifndef STATIC_FILE_CACHE_H
+#define STATIC_FILE_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Validators for a static file, computed once and reused until the file changes
+struct FileValidators {
+    String etag;
+    String lastModified;
+    size_t size = 0;
+    time_t lastWrite = 0;
+    unsigned long checkedAt = 0;
+};
+
+// Which representations of a static file are on flash, rechecked like its validators
+struct FileVariants {
+    bool plain = false;
+    bool gzip = false;
+    unsigned long checkedAt = 0;
+};
+
+// File content held resident in PSRAM; freed once the cache and all in-flight responses drop it
+struct CachedFile {
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    String etag;
+    
+    ~CachedFile();
+};
+
+// Conditional-GET support for Response::file(): ETags, Last-Modified and Cache-Control policies
+class StaticFileCache {
+private:
+    static StaticFileCache* instance;
+    std::map<String, FileValidators> validators;
+    std::map<String, FileVariants> variants; // Only files with at least one representation
+    std::vector<std::pair<String, String>> cachePolicies; // Path prefix -> Cache-Control
+    unsigned long revalidateMs = 10000;
+    
+    // Opt-in LRU of hot file contents, most recently used first
+    struct ContentEntry {
+        std::shared_ptr<CachedFile> file;
+        std::list<String>::iterator position;
+    };
+    std::map<String, ContentEntry> contents;
+    std::list<String> contentOrder;
+    size_t contentBudget = 0;
+    size_t contentMaxFileSize = 0;
+    size_t contentBytes = 0;
+    bool cacheGzip = true;
+    unsigned long contentHits = 0;
+    unsigned long contentMisses = 0;
+    unsigned long long contentBytesServed = 0;
+    
+    StaticFileCache() = default;
+    
+    static String computeEtag(File& file);
+    static String formatHttpDate(time_t value);
+    
+    void dropContent(const String& path);
+    std::shared_ptr<CachedFile> loadContent(FS& storage, const String& path, const FileValidators& validators, File* opened);
+
+public:
+    static StaticFileCache* getInstance();
+    
+    // Validators for path, or nullptr if the file does not exist.
+    // When the file had to be opened, the handle is rewound and passed back through opened.
+    const FileValidators* validatorsFor(FS& storage, const String& path, File* opened = nullptr);
+    
+    // Whether path and its precompressed path + ".gz" exist, without touching the filesystem while fresh
+    const FileVariants& variantsFor(FS& storage, const String& path);
+    
+    // Drop cached validators after a file (or its .gz sidecar) is rewritten
+    void invalidate(const String& path);
+    void invalidateAll();
+    
+    // How long cached validators are trusted before the file metadata is checked again.
+    // Without modification times (SPIFFS) each recheck rehashes the file; invalidate() still applies at once.
+    void setRevalidateInterval(unsigned long ms) { revalidateMs = ms; }
+    
+    // Cache-Control for paths starting with prefix; the longest matching prefix wins
+    void setCachePolicy(const String& prefix, const String& cacheControl);
+    String cachePolicyFor(const String& path) const;
+    
+    // Keep hot files in PSRAM, up to budget bytes in total and maxFileSize per file (0 = budget / 4)
+    bool enableContentCache(size_t budget, size_t maxFileSize = 0, bool includeGzip = true);
+    void disableContentCache();
+    bool isContentCacheEnabled() const { return contentBudget > 0; }
+    
+    // Resident content for path if cacheable, loading it on a miss (from opened when given); nullptr means serve from flash
+    std::shared_ptr<CachedFile> content(FS& storage, const String& path, const FileValidators& validators, File* opened = nullptr);
+    
+    // Content cache statistics
+    unsigned long getContentHits() const { return contentHits; }
+    unsigned long getContentMisses() const { return contentMisses; }
+    unsigned long long getContentBytesServed() const { return contentBytesServed; }
+    size_t getContentBytes() const { return contentBytes; }
+    float getContentHitRatio() const;
+    void resetContentStats();
+};
+
+#endif
@@ -8,9 +8,14 @@
 
 #include "Routing/Router.h"
 
+#include "Http/HttpMethod.h"
 #include "Http/Middleware.h"
 #include "Http/Request.h"
+#include "Http/AuthToken.h"
 #include "Http/Response.h"
+#include "Http/StaticFileCache.h"
+#include "Http/ResponseCache.h"
+#include "Http/EmbeddedAsset.h"
 #include "Http/Controller.h"
 #include "Http/WebSocketRequest.h"
 
@@ -20,5 +25,6 @@
 #include "Core/Application.h"
 #include "Core/ServiceContainer.h"
 #include "Core/ApplicationTemplates.h"
+#include "Core/PsramAllocator.h"
 
 #endif
\ No newline at end of file
@@ -3,45 +3,57 @@
 #include "../Http/Response.h"
 #include "../Http/WebSocketRequest.h"
 #include "../Http/Middleware.h"
+#include <algorithm>
 #include <regex>
 
 Router::Router(AsyncWebServer* webServer) : server(webServer) {
 }
 
 Router& Router::get(const String& path, std::function<Response(Request&)> handler) {
-    addRoute("GET", path, handler);
+    addRoute(METHOD_GET, path, handler);
 		return *this;
 }
 
 Router& Router::post(const String& path, std::function<Response(Request&)> handler) {
-    addRoute("POST", path, handler);
+    addRoute(METHOD_POST, path, handler);
 		return *this;
 }
 
 Router& Router::put(const String& path, std::function<Response(Request&)> handler) {
-    addRoute("PUT", path, handler);
+    addRoute(METHOD_PUT, path, handler);
 		return *this;
 }
 
 Router& Router::patch(const String& path, std::function<Response(Request&)> handler) {
-    addRoute("PATCH", path, handler);
+    addRoute(METHOD_PATCH, path, handler);
 		return *this;
 }
 
 Router& Router::delete_(const String& path, std::function<Response(Request&)> handler) {
-    addRoute("DELETE", path, handler);
+    addRoute(METHOD_DELETE, path, handler);
 		return *this;
 }
 
-Router& Router::any(const String& path, std::function<Response(Request&)> handler) {
-    addRoute("GET", path, handler);
-    addRoute("POST", path, handler);
-    addRoute("PUT", path, handler);
-    addRoute("PATCH", path, handler);
-    addRoute("DELETE", path, handler);
+Router& Router::head(const String& path, std::function<Response(Request&)> handler) {
+    addRoute(METHOD_HEAD, path, handler);
+    return *this;
+}
+
+Router& Router::options(const String& path, std::function<Response(Request&)> handler) {
+    addRoute(METHOD_OPTIONS, path, handler);
+    return *this;
+}
+
+// One route entry shared by every method in the mask
+Router& Router::match(uint8_t methods, const String& path, std::function<Response(Request&)> handler) {
+    addRoute(methods, path, handler);
     return *this;
 }
 
+Router& Router::any(const String& path, std::function<Response(Request&)> handler) {
+    return match(METHOD_GET | METHOD_POST | METHOD_PUT | METHOD_PATCH | METHOD_DELETE, path, handler);
+}
+
 // WebSocket route registration
 Router& Router::websocket(const String& path) {
     currentWsRoute = &addWebSocketRoute(path);
@@ -102,37 +114,153 @@ Router& Router::middleware(const std::vector<String>& names) {
 
 Router& Router::name(const String& routeName) {
     if (!routes.empty()) {
-        routes.back().name = routeName;
+        Route& route = routes.back();
+        route.name = routeName;
+        compileUrlTemplate(route);
+        
+        // First route registered under a name wins
+        namedRoutes.emplace(routeName, routes.size() - 1);
     }
     return *this;
 }
 
-String Router::route(const String& name, const std::map<String, String>& parameters) {
-    for (const Route& route : routes) {
-        if (route.name == name) {
-            String path = route.path;
-            // Replace parameters in path
-            for (const auto& param : parameters) {
-                path.replace("{" + param.first + "}", param.second);
-            }
-            return path;
+Router& Router::assets(const EmbeddedAsset* assets, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const EmbeddedAsset* asset = &assets[i];
+        get(asset->path, [asset](Request& request) -> Response {
+            return Response(request.getServerRequest()).asset(*asset);
+        });
+    }
+    return *this;
+}
+
+Router& Router::uncompressed() {
+    if (!routes.empty()) {
+        routes.back().compress = false;
+    }
+    return *this;
+}
+
+Router& Router::cache(unsigned long ttlMs) {
+    if (!routes.empty()) {
+        Route& route = routes.back();
+        route.cacheTtl = ttlMs;
+        
+        // Runs after the route's other middleware, so auth is still checked on hits
+        if (std::find(route.middleware.begin(), route.middleware.end(), "cache") == route.middleware.end()) {
+            route.middleware.push_back("cache");
+            routesDirty = true;
+        }
+    }
+    return *this;
+}
+
+Router& Router::coalesce(unsigned long windowMs) {
+    if (!routes.empty()) {
+        // The key does not include the body, so only GET and HEAD requests can be shared
+        if (!(routes.back().methods & (METHOD_GET | METHOD_HEAD))) {
+            Serial.println("[Router] coalesce() ignored on route without GET or HEAD: " + routes.back().path);
+            return *this;
+        }
+        routes.back().coalesceWindow = windowMs;
+    }
+    return *this;
+}
+
+Router& Router::critical() {
+    if (!routes.empty()) {
+        routes.back().critical = true;
+    }
+    return *this;
+}
+
+String Router::route(const String& name, const std::map<String, String>& parameters) const {
+    auto it = namedRoutes.find(name);
+    if (it == namedRoutes.end()) {
+        return "";
+    }
+    
+    const Route& route = routes[it->second];
+    
+    // Size the result once, then append fragments in order
+    size_t length = route.urlLiteralLength;
+    for (const RouteFragment& fragment : route.urlTemplate) {
+        if (fragment.isParam) {
+            auto param = parameters.find(fragment.text);
+            length += param != parameters.end() ? param->second.length() : fragment.text.length() + 2;
+        }
+    }
+    
+    String url;
+    url.reserve(length);
+    for (const RouteFragment& fragment : route.urlTemplate) {
+        if (!fragment.isParam) {
+            url += fragment.text;
+            continue;
+        }
+        
+        auto param = parameters.find(fragment.text);
+        if (param != parameters.end()) {
+            url += param->second;
+        } else {
+            // Leave unresolved placeholders in place
+            url += '{';
+            url += fragment.text;
+            url += '}';
+        }
+    }
+    return url;
+}
+
+void Router::compileUrlTemplate(Route& route) {
+    route.urlTemplate.clear();
+    route.urlLiteralLength = 0;
+    
+    const String& path = route.path;
+    int literalStart = 0;
+    int openBrace = path.indexOf('{');
+    
+    while (openBrace >= 0) {
+        int closeBrace = path.indexOf('}', openBrace);
+        if (closeBrace < 0) {
+            break;
         }
+        
+        if (openBrace > literalStart) {
+            route.urlTemplate.push_back({path.substring(literalStart, openBrace), false});
+            route.urlLiteralLength += openBrace - literalStart;
+        }
+        route.urlTemplate.push_back({path.substring(openBrace + 1, closeBrace), true});
+        
+        literalStart = closeBrace + 1;
+        openBrace = path.indexOf('{', literalStart);
+    }
+    
+    if (literalStart < (int)path.length()) {
+        route.urlTemplate.push_back({path.substring(literalStart), false});
+        route.urlLiteralLength += path.length() - literalStart;
     }
-    return "";
 }
 
 void Router::registerMiddleware(const String& name, std::shared_ptr<Middleware> middleware) {
     middlewares[name] = middleware;
+    routesDirty = true;
+}
+
+Middleware* Router::getMiddleware(const String& name) const {
+    auto it = middlewares.find(name);
+    return it != middlewares.end() ? it->second.get() : nullptr;
 }
 
-Route& Router::addRoute(const String& method, const String& path, std::function<Response(Request&)> handler) {
+Route& Router::addRoute(uint8_t methods, const String& path, std::function<Response(Request&)> handler) {
     Route route;
-    route.method = method;
+    route.methods = methods;
     route.path = prefix + path;
     route.handler = handler;
     route.middleware = middlewareStack;
     
     routes.push_back(route);
+    routesDirty = true;
     return routes.back();
 }
 
@@ -158,97 +286,267 @@ WebSocketRoute& Router::addWebSocketRoute(const String& path) {
     return wsRoutes.back();
 }
 
-bool Router::matchRoute(const Route& route, const String& method, const String& path, std::map<String, String>& params) {
-    if (route.method != method && route.method != "ANY") {
-        return false;
-    }
+bool Router::compileRoutes() {
+    bool valid = true;
     
-    // Exact match first (no parameters)
-    if (route.path == path) {
-        return true;
+    for (int i = 0; i < HTTP_METHOD_COUNT; i++) {
+        routeTrees[i].reset(new RouteNode());
     }
     
-    // Check for parameters in route
-    if (route.path.indexOf('{') >= 0) {
-        // Split both paths into segments
-        std::vector<String> routeSegments;
-        std::vector<String> pathSegments;
-        
-        // Parse route path segments
-        String routeCopy = route.path;
-        if (routeCopy.startsWith("/")) routeCopy = routeCopy.substring(1);
-        if (routeCopy.endsWith("/")) routeCopy = routeCopy.substring(0, routeCopy.length() - 1);
-        
-        int start = 0;
-        for (int i = 0; i <= routeCopy.length(); i++) {
-            if (i == routeCopy.length() || routeCopy.charAt(i) == '/') {
-                if (i > start) {
-                    routeSegments.push_back(routeCopy.substring(start, i));
-                }
-                start = i + 1;
-            }
+    for (Route& route : routes) {
+        // Never serve a route whose middleware could not be resolved
+        if (!resolveMiddleware(route)) {
+            valid = false;
+            continue;
         }
         
-        // Parse request path segments
-        String pathCopy = path;
-        if (pathCopy.startsWith("/")) pathCopy = pathCopy.substring(1);
-        if (pathCopy.endsWith("/")) pathCopy = pathCopy.substring(0, pathCopy.length() - 1);
-        
-        start = 0;
-        for (int i = 0; i <= pathCopy.length(); i++) {
-            if (i == pathCopy.length() || pathCopy.charAt(i) == '/') {
-                if (i > start) {
-                    pathSegments.push_back(pathCopy.substring(start, i));
-                }
-                start = i + 1;
+        // A route lands in the trie of every method in its mask
+        for (int i = 0; i < HTTP_METHOD_COUNT; i++) {
+            if (route.methods & (1 << i)) {
+                insertRoute(routeTrees[i].get(), route);
             }
         }
-        
-        // Must have same number of segments
-        if (routeSegments.size() != pathSegments.size()) {
+    }
+    
+    // Cached Route pointers are invalid once the tries are rebuilt
+    clearRouteCache();
+    coalescedResults.clear();
+    
+    routesDirty = false;
+    return valid;
+}
+
+bool Router::resolveMiddleware(Route& route) {
+    route.pipeline.clear();
+    route.pipeline.reserve(route.middleware.size());
+    
+    for (const String& middlewareName : route.middleware) {
+        auto middlewareIt = middlewares.find(middlewareName);
+        if (middlewareIt == middlewares.end()) {
+            Serial.printf("[Router] Unknown middleware '%s' on route %s\n", 
+                          middlewareName.c_str(), route.path.c_str());
+            route.pipeline.clear();
             return false;
         }
-        
-        // Match each segment
-        for (size_t i = 0; i < routeSegments.size(); i++) {
-            String routeSegment = routeSegments[i];
-            String pathSegment = pathSegments[i];
+        route.pipeline.push_back(middlewareIt->second.get());
+    }
+    
+    return true;
+}
+
+void Router::insertRoute(RouteNode* root, Route& route) {
+    RouteNode* node = root;
+    route.paramNames.clear();
+    
+    const String& path = route.path;
+    int start = 0;
+    for (int i = 0; i <= (int)path.length(); i++) {
+        if (i < (int)path.length() && path.charAt(i) != '/') {
+            continue;
+        }
+        if (i > start) {
+            String segment = path.substring(start, i);
             
-            if (routeSegment.startsWith("{") && routeSegment.endsWith("}")) {
-                // This is a parameter, extract it
-                String paramName = routeSegment.substring(1, routeSegment.length() - 1);
-                params[paramName] = pathSegment;
-            } else if (routeSegment != pathSegment) {
-                // Static segment must match exactly
-                return false;
+            if (segment.startsWith("{") && segment.endsWith("}")) {
+                if (route.paramNames.size() >= ROUTER_MAX_PARAMS) {
+                    Serial.println("[Router] Too many parameters in route: " + path);
+                    return;
+                }
+                route.paramNames.push_back(segment.substring(1, segment.length() - 1));
+                if (!node->paramChild) {
+                    node->paramChild.reset(new RouteNode());
+                }
+                node = node->paramChild.get();
+            } else {
+                RouteNode* next = nullptr;
+                for (auto& child : node->children) {
+                    if (child->segment == segment) {
+                        next = child.get();
+                        break;
+                    }
+                }
+                if (!next) {
+                    next = new RouteNode();
+                    next->segment = segment;
+                    node->children.emplace_back(next);
+                }
+                node = next;
             }
         }
+        start = i + 1;
+    }
+    
+    // First registration wins, matching the previous linear scan order
+    if (!node->route) {
+        node->route = &route;
+    }
+}
+
+const Route* Router::findRoute(HttpMethod method, const char* path, size_t length, RouteMatch& match) const {
+    int slot = httpMethodIndex(method);
+    if (slot < 0 || !routeTrees[slot]) {
+        return nullptr;
+    }
+    
+    match.route = nullptr;
+    match.paramCount = 0;
+    if (!matchNode(routeTrees[slot].get(), path, path + length, match)) {
+        return nullptr;
+    }
+    return match.route;
+}
+
+void Router::enableRouteCache(size_t capacity) {
+    routeCache.clear();
+    routeCache.shrink_to_fit();
+    routeCache.resize(capacity);
+}
+
+void Router::clearRouteCache() {
+    for (RouteCacheEntry& entry : routeCache) {
+        entry.route = nullptr;
+        entry.path = "";
+    }
+    routeCacheTick = 0;
+}
+
+uint32_t Router::hashPath(HttpMethod method, const char* path, size_t length) {
+    // FNV-1a over the method bit and path bytes
+    uint32_t hash = 2166136261u ^ method;
+    hash *= 16777619u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)path[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const Route* Router::resolveRoute(HttpMethod method, const String& path, RouteMatch& match) {
+    if (routeCache.empty()) {
+        return findRoute(method, path.c_str(), path.length(), match);
+    }
+    
+    uint32_t hash = hashPath(method, path.c_str(), path.length());
+    RouteCacheEntry* victim = &routeCache[0];
+    
+    for (RouteCacheEntry& entry : routeCache) {
+        if (entry.route && entry.hash == hash && entry.method == method && entry.path == path) {
+            entry.lastUsed = ++routeCacheTick;
+            routeCacheHits++;
+            
+            match.route = entry.route;
+            match.paramCount = entry.paramCount;
+            for (uint8_t i = 0; i < entry.paramCount; i++) {
+                match.params[i].value = path.c_str() + entry.params[i].offset;
+                match.params[i].length = entry.params[i].length;
+            }
+            return entry.route;
+        }
         
-        return true;
+        // Track an empty or least recently used slot for insertion
+        if (victim->route && (!entry.route || entry.lastUsed < victim->lastUsed)) {
+            victim = &entry;
+        }
+    }
+    
+    routeCacheMisses++;
+    const Route* route = findRoute(method, path.c_str(), path.length(), match);
+    if (!route) {
+        return nullptr;
+    }
+    
+    victim->hash = hash;
+    victim->method = method;
+    victim->path = path;
+    victim->route = route;
+    victim->lastUsed = ++routeCacheTick;
+    victim->paramCount = match.paramCount;
+    for (uint8_t i = 0; i < match.paramCount; i++) {
+        victim->params[i].offset = match.params[i].value - path.c_str();
+        victim->params[i].length = match.params[i].length;
+    }
+    return route;
+}
+
+uint8_t Router::allowedMethods(const char* path, size_t length) const {
+    uint8_t allowed = 0;
+    RouteMatch match;
+    
+    for (int i = 0; i < HTTP_METHOD_COUNT; i++) {
+        HttpMethod method = (HttpMethod)(1 << i);
+        if (findRoute(method, path, length, match)) {
+            allowed |= method;
+        }
+    }
+    
+    if (allowed & METHOD_GET) {
+        allowed |= METHOD_HEAD;
+    }
+    return allowed;
+}
+
+bool Router::matchNode(const RouteNode* node, const char* path, const char* end, RouteMatch& match) {
+    while (path < end && *path == '/') {
+        path++;
+    }
+    
+    if (path == end) {
+        if (node->route) {
+            match.route = node->route;
+            return true;
+        }
+        return false;
+    }
+    
+    const char* segmentEnd = path;
+    while (segmentEnd < end && *segmentEnd != '/') {
+        segmentEnd++;
+    }
+    size_t length = segmentEnd - path;
+    
+    // Static segments take precedence over parameters
+    for (const auto& child : node->children) {
+        if (child->segment.length() == length &&
+            memcmp(child->segment.c_str(), path, length) == 0 &&
+            matchNode(child.get(), segmentEnd, end, match)) {
+            return true;
+        }
+    }
+    
+    if (node->paramChild && match.paramCount < ROUTER_MAX_PARAMS) {
+        uint8_t index = match.paramCount++;
+        match.params[index].value = path;
+        match.params[index].length = length;
+        if (matchNode(node->paramChild.get(), segmentEnd, end, match)) {
+            return true;
+        }
+        match.paramCount--;
     }
     
     return false;
 }
 
-void Router::init() {
+bool Router::init() {
+    // Compile registered routes into per-method lookup tries
+    if (!compileRoutes()) {
+        Serial.println("[Router] Route compilation failed, server not started");
+        return false;
+    }
+    
+    // Buffer raw request bodies per request
+    Request::setupBodyHandling(server);
+    
     // Register all routes with the AsyncWebServer
     server->onNotFound([this](AsyncWebServerRequest* request) {
         handleRequest(request);
     });
     
     server->begin();
+    return true;
 }
 
 void Router::handleRequest(AsyncWebServerRequest* request) {
-    String method;
-    switch (request->method()) {
-        case HTTP_GET: method = "GET"; break;
-        case HTTP_POST: method = "POST"; break;
-        case HTTP_PUT: method = "PUT"; break;
-        case HTTP_DELETE: method = "DELETE"; break;
-        case HTTP_PATCH: method = "PATCH"; break;
-        default: method = "GET"; break;
-    }
+    HttpMethod method = toHttpMethod(request->method());
     
     String path = request->url();
     
@@ -258,85 +556,182 @@ void Router::handleRequest(AsyncWebServerRequest* request) {
         path = path.substring(0, queryIndex);
     }
     
-    Serial.println("[DEBUG] Router handling: " + method + " " + path);
+    Serial.printf("[DEBUG] Router handling: %s %s\n", httpMethodName(method), path.c_str());
     
-    // Find matching route - sort routes by specificity (routes without parameters first)
-    std::vector<const Route*> candidateRoutes;
+    if (method == METHOD_NONE) {
+        request->send(501, "text/plain", "Not Implemented");
+        return;
+    }
     
-    // First pass: exact matches (no parameters)
-    for (const Route& route : routes) {
-        if (route.method == method && route.path == path) {
-            candidateRoutes.push_back(&route);
-            break; // Exact match found, use it
-        }
+    // Body handler refused the upload (too large or out of memory)
+    int bodyError = Request::bodyError(request);
+    if (bodyError == 413) {
+        request->send(413, "text/plain", "Payload Too Large");
+        return;
+    } else if (bodyError != 0) {
+        request->send(bodyError, "text/plain", "Service Unavailable");
+        return;
     }
     
-    // Second pass: parametric routes if no exact match
-    if (candidateRoutes.empty()) {
-        for (const Route& route : routes) {
-            if (route.method == method && route.path.indexOf('{') >= 0) {
-                std::map<String, String> params;
-                if (matchRoute(route, method, path, params)) {
-                    candidateRoutes.push_back(&route);
-                    // For parametric routes, use the first match
-                    break;
-                }
-            }
-        }
+    // Routes registered after init() are picked up on the next request
+    if (routesDirty) {
+        compileRoutes();
     }
     
-    if (!candidateRoutes.empty()) {
-        const Route* matchedRoute = candidateRoutes[0];
-        
-        // Create request object
-        Request req(request);
-        
-        // Set route parameters for parametric routes
-        if (matchedRoute->path.indexOf('{') >= 0) {
-            std::map<String, String> params;
-            matchRoute(*matchedRoute, method, path, params);
-            for (const auto& param : params) {
-                req.setRouteParameter(param.first, param.second);
+    RouteMatch match;
+    const Route* matchedRoute = resolveRoute(method, path, match);
+    
+    // HEAD is served by the GET route unless one was registered explicitly
+    if (!matchedRoute && method == METHOD_HEAD) {
+        matchedRoute = resolveRoute(METHOD_GET, path, match);
+    }
+    
+    if (matchedRoute) {
+        dispatch(*matchedRoute, match, request, matchedRoute->handler);
+        return;
+    }
+    
+    // Answer OPTIONS for known paths through the route's middleware so CORS can respond
+    if (method == METHOD_OPTIONS) {
+        uint8_t allowed = allowedMethods(path.c_str(), path.length());
+        if (allowed) {
+            String allow = "OPTIONS";
+            for (int i = 0; i < HTTP_METHOD_COUNT; i++) {
+                HttpMethod bit = (HttpMethod)(1 << i);
+                if ((allowed & bit) && bit != METHOD_OPTIONS) {
+                    allow += ", ";
+                    allow += httpMethodName(bit);
+                }
             }
+            
+            HttpMethod routeMethod = (HttpMethod)(allowed & -allowed);
+            const Route* route = findRoute(routeMethod, path.c_str(), path.length(), match);
+            std::function<Response(Request&)> preflight = [allow](Request& req) -> Response {
+                return Response(req.getServerRequest())
+                    .status(204)
+                    .header("Allow", allow)
+                    .content("");
+            };
+            dispatch(*route, match, request, preflight);
+            return;
         }
-        
-        // Execute middleware chain
-        Response response = executeMiddleware(matchedRoute->middleware, req, matchedRoute->handler);
-        
-        // Send response
-        response.send();
-        return;
     }
     
     // No route found
-    Serial.println("[DEBUG] No route found for: " + method + " " + path);
+    Serial.printf("[DEBUG] No route found for: %s %s\n", httpMethodName(method), path.c_str());
     request->send(404, "text/plain", "Not Found");
 }
 
-Response Router::executeMiddleware(const std::vector<String>& middleware, Request& request, std::function<Response(Request&)> finalHandler) {
-    if (middleware.empty()) {
-        return finalHandler(request);
+void Router::dispatch(const Route& route, const RouteMatch& match, AsyncWebServerRequest* request, const std::function<Response(Request&)>& handler) {
+    // Create request object
+    Request req(request);
+    req.setMatchedRoute(&route);
+    
+    // Set route parameters captured during lookup
+    for (uint8_t i = 0; i < match.paramCount; i++) {
+        req.setRouteParameter(route.paramNames[i], 
+                              String(match.params[i].value, match.params[i].length));
     }
     
-    // Create middleware chain
-    std::function<Response(Request&)> next = finalHandler;
+    // Drop results whose window has passed
+    if (!coalescedResults.empty()) {
+        expireCoalescedResults(millis());
+    }
     
-    // Build chain in reverse order
-    for (auto it = middleware.rbegin(); it != middleware.rend(); ++it) {
-        const String& middlewareName = *it;
-        auto middlewareIt = middlewares.find(middlewareName);
+    // Execute middleware chain
+    HttpMethod method = toHttpMethod(request->method());
+    bool coalesced = route.coalesceWindow > 0 && (method & (METHOD_GET | METHOD_HEAD));
+    Response response = coalesced ? executeCoalesced(route, req, handler)
+                                  : executeMiddleware(route, req, handler);
+    if (!route.compress) {
+        response.compress(false);
+    }
+    
+    // Uploaded files replace their destination only when the handler accepted them
+    req.finishUploads(response.getStatusCode());
+    
+    // Send response
+    response.send();
+}
+
+Response Router::executeMiddleware(const Route& route, Request& request, const std::function<Response(Request&)>& handler) {
+    // Dispatch through the pipeline resolved at compile time
+    MiddlewareChain chain(route.pipeline.data(), route.pipeline.size(), handler);
+    return chain(request);
+}
+
+// Handlers run one at a time on the server task, so requests that arrive while a handler is
+// busy are dispatched right after it returns. Keeping the result for the route's window lets
+// those requests join that run instead of repeating it. Middleware still runs for every
+// request; only the handler is shared, keyed by method and URL. The body is not compared, so
+// dispatch() only coalesces GET and HEAD requests.
+Response Router::executeCoalesced(const Route& route, Request& request, const std::function<Response(Request&)>& handler) {
+    struct Context {
+        Router* router;
+        const Route* route;
+        const std::function<Response(Request&)>* handler;
+    } context = {this, &route, &handler};
+    
+    // Captures a single reference, so the wrapper needs no heap allocation
+    std::function<Response(Request&)> shared = [&context](Request& req) -> Response {
+        Router* router = context.router;
+        String key = req.method();
+        key += ' ';
+        key += req.url();
         
-        if (middlewareIt != middlewares.end()) {
-            auto middleware = middlewareIt->second;
-            auto currentNext = next;
+        std::vector<CoalescedResult>& results = router->coalescedResults;
+        for (auto it = results.begin(); it != results.end(); ++it) {
+            if (it->route != context.route || it->key != key) continue;
             
-            next = [middleware, currentNext](Request& req) -> Response {
-                return middleware->handle(req, currentNext);
-            };
+            std::shared_ptr<OwnedBinary> binary = it->binary.lock();
+            if (it->sharesBinary && !binary) {
+                // Every response sending the payload has finished and released it
+                results.erase(it);
+                break;
+            }
+            
+            router->coalescedRequests++;
+            Response copy = it->response->replicate(req.getServerRequest());
+            if (binary) {
+                copy.setOwnedBinary(std::move(binary));
+            }
+            return copy;
         }
-    }
+        
+        router->coalesceExecutions++;
+        Response response = (*context.handler)(req);
+        if (response.isReplicable()) {
+            // Serialize a document once for every request that joins
+            if (response.hasJsonDocument()) {
+                response.content(response.getContent());
+            }
+            CoalescedResult result;
+            result.route = context.route;
+            result.key = key;
+            result.completedAt = millis();
+            result.response = std::make_shared<Response>(response.replicate(nullptr));
+            if (response.getOwnedBinary()) {
+                result.sharesBinary = true;
+                result.binary = response.getOwnedBinary();
+                result.response->setOwnedBinary(nullptr);
+            }
+            results.push_back(std::move(result));
+        }
+        return response;
+    };
     
-    return next(request);
+    MiddlewareChain chain(route.pipeline.data(), route.pipeline.size(), shared);
+    return chain(request);
+}
+
+void Router::expireCoalescedResults(unsigned long now) {
+    for (auto it = coalescedResults.begin(); it != coalescedResults.end();) {
+        if (now - it->completedAt >= it->route->coalesceWindow) {
+            it = coalescedResults.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 void Router::handleWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len) {
@@ -4,8 +4,22 @@
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <functional>
+#include <memory>
+#include "../Http/HttpMethod.h"
+#include "../Http/EmbeddedAsset.h"
+
+// Maximum number of {param} segments captured for a single route
+#ifndef ROUTER_MAX_PARAMS
+#define ROUTER_MAX_PARAMS 8
+#endif
+
+// Default window of coalesce() in ms
+#ifndef ROUTER_COALESCE_WINDOW
+#define ROUTER_COALESCE_WINDOW 200
+#endif
 
 // Forward declarations
 class Request;
@@ -13,14 +27,86 @@ class Response;
 class Middleware;
 class WebSocketRequest;
 class WebSocketResponse;
+struct OwnedBinary;
+
+// Literal text or {param} placeholder of a named route's URL template
+struct RouteFragment {
+    String text;
+    bool isParam;
+};
 
 struct Route {
-    String method;
+    uint8_t methods; // Mask of HttpMethod bits
     String path;
     std::function<Response(Request&)> handler;
     std::vector<String> middleware;
     String name;
     std::map<String, String> parameters;
+    std::vector<String> paramNames; // {param} names in path order, filled by compileRoutes()
+    std::vector<Middleware*> pipeline; // Resolved middleware, filled by compileRoutes()
+    std::vector<RouteFragment> urlTemplate; // Precompiled by name() for reverse routing
+    size_t urlLiteralLength = 0;
+    bool compress = true; // Cleared by uncompressed()
+    unsigned long cacheTtl = 0; // Set by cache()
+    unsigned long coalesceWindow = 0; // Set by coalesce()
+    bool critical = false; // Set by critical()
+};
+
+struct StringHash {
+    size_t operator()(const String& value) const {
+        // FNV-1a
+        size_t hash = 2166136261u;
+        for (const char* p = value.c_str(); *p; p++) {
+            hash ^= (uint8_t)*p;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+// Segment trie node; static children are tried before the {param} child
+struct RouteNode {
+    String segment;
+    std::vector<std::unique_ptr<RouteNode>> children;
+    std::unique_ptr<RouteNode> paramChild;
+    const Route* route = nullptr;
+};
+
+// Result of a trie lookup; parameter values point into the request path
+struct RouteMatch {
+    const Route* route = nullptr;
+    uint8_t paramCount = 0;
+    struct {
+        const char* value;
+        uint16_t length;
+    } params[ROUTER_MAX_PARAMS];
+};
+
+// Resolved-route cache entry; parameters are offsets into the cached path
+struct RouteCacheEntry {
+    uint32_t hash = 0;
+    HttpMethod method = METHOD_NONE;
+    String path;
+    const Route* route = nullptr;
+    uint32_t lastUsed = 0;
+    uint8_t paramCount = 0;
+    struct {
+        uint16_t offset;
+        uint16_t length;
+    } params[ROUTER_MAX_PARAMS];
+};
+
+// Handler result shared with identical requests on a coalesce() route
+struct CoalescedResult {
+    const Route* route;
+    String key;
+    unsigned long completedAt;
+    std::shared_ptr<Response> response; // Template replicated for each joining request
+    
+    // An owned payload (a camera frame) is held weakly, so it is released as soon as the
+    // responses sending it are done; once it is gone the result no longer applies
+    bool sharesBinary = false;
+    std::weak_ptr<OwnedBinary> binary;
 };
 
 struct WebSocketRoute {
@@ -42,6 +128,22 @@ private:
     std::map<String, std::shared_ptr<Middleware>> middlewares;
     String prefix;
     std::vector<String> middlewareStack;
+    std::unordered_map<String, size_t, StringHash> namedRoutes; // Name -> index into routes
+    
+    // Compiled route tries, one per method (indexed by httpMethodIndex())
+    std::unique_ptr<RouteNode> routeTrees[HTTP_METHOD_COUNT];
+    bool routesDirty = true;
+    
+    // Optional LRU cache of resolved routes (disabled while empty)
+    std::vector<RouteCacheEntry> routeCache;
+    uint32_t routeCacheTick = 0;
+    uint32_t routeCacheHits = 0;
+    uint32_t routeCacheMisses = 0;
+    
+    // Fresh results of coalesce() routes
+    std::vector<CoalescedResult> coalescedResults;
+    uint32_t coalesceExecutions = 0;
+    uint32_t coalescedRequests = 0;
 
 public:
     Router(AsyncWebServer* webServer);
@@ -52,7 +154,10 @@ public:
     Router& put(const String& path, std::function<Response(Request&)> handler);
     Router& patch(const String& path, std::function<Response(Request&)> handler);
     Router& delete_(const String& path, std::function<Response(Request&)> handler);
+    Router& head(const String& path, std::function<Response(Request&)> handler);
+    Router& options(const String& path, std::function<Response(Request&)> handler);
     Router& any(const String& path, std::function<Response(Request&)> handler);
+    Router& match(uint8_t methods, const String& path, std::function<Response(Request&)> handler);
     
     // WebSocket registration
     Router& websocket(const String& path);
@@ -68,7 +173,17 @@ public:
     
     // Named routes
     Router& name(const String& routeName);
-    String route(const String& name, const std::map<String, String>& parameters = {});
+    String route(const String& name, const std::map<String, String>& parameters = {}) const;
+    bool hasRoute(const String& name) const { return namedRoutes.find(name) != namedRoutes.end(); }
+    
+    // Serve each embedded asset under its own path
+    Router& assets(const EmbeddedAsset* assets, size_t count);
+    
+    // Route options
+    Router& uncompressed(); // Never gzip this route's responses
+    Router& cache(unsigned long ttlMs); // Memoize responses through the "cache" middleware
+    Router& coalesce(unsigned long windowMs = ROUTER_COALESCE_WINDOW); // Share one handler run between identical GET/HEAD requests
+    Router& critical(); // Admitted by the "admission" middleware while other routes are shed
     
     // Controller routes
     Router& controller(const String& path, const String& controller);
@@ -76,10 +191,26 @@ public:
     
     // Middleware management
     void registerMiddleware(const String& name, std::shared_ptr<Middleware> middleware);
+    Middleware* getMiddleware(const String& name) const;
+    
+    // Resolved-route cache; capacity 0 disables it
+    void enableRouteCache(size_t capacity = 16);
+    void clearRouteCache();
+    void resetRouteCacheStats() { routeCacheHits = 0; routeCacheMisses = 0; }
+    size_t getRouteCacheCapacity() const { return routeCache.size(); }
+    uint32_t getRouteCacheHits() const { return routeCacheHits; }
+    uint32_t getRouteCacheMisses() const { return routeCacheMisses; }
+    
+    // Request coalescing: handler runs on coalesce() routes, and requests answered from another run
+    uint32_t getCoalesceExecutions() const { return coalesceExecutions; }
+    uint32_t getCoalescedRequests() const { return coalescedRequests; }
+    void resetCoalesceStats() { coalesceExecutions = 0; coalescedRequests = 0; }
     
     // Route matching and execution
-    bool match(const String& method, const String& path, AsyncWebServerRequest* request);
     void handleRequest(AsyncWebServerRequest* request);
+    
+    // Lookup without dispatching (after init()); parameter values point into path
+    const Route* resolveRoute(HttpMethod method, const String& path, RouteMatch& match);
     void handleWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
     
     // WebSocket utilities
@@ -88,15 +219,25 @@ public:
     void sendToClient(const String& path, uint32_t clientId, const String& message);
     AsyncWebSocket* getWebSocket(const String& path);
     
-    // Initialize routes on server
-    void init();
+    // Initialize routes on server; returns false if any route references unknown middleware
+    bool init();
     
 private:
-    Route& addRoute(const String& method, const String& path, std::function<Response(Request&)> handler);
+    Route& addRoute(uint8_t methods, const String& path, std::function<Response(Request&)> handler);
     WebSocketRoute& addWebSocketRoute(const String& path);
-    bool matchRoute(const Route& route, const String& method, const String& path, std::map<String, String>& params);
     String compilePath(const String& path);
-    Response executeMiddleware(const std::vector<String>& middleware, Request& request, std::function<Response(Request&)> next);
+    static void compileUrlTemplate(Route& route);
+    bool compileRoutes();
+    bool resolveMiddleware(Route& route);
+    void insertRoute(RouteNode* root, Route& route);
+    const Route* findRoute(HttpMethod method, const char* path, size_t length, RouteMatch& match) const;
+    uint8_t allowedMethods(const char* path, size_t length) const;
+    static uint32_t hashPath(HttpMethod method, const char* path, size_t length);
+    static bool matchNode(const RouteNode* node, const char* path, const char* end, RouteMatch& match);
+    void dispatch(const Route& route, const RouteMatch& match, AsyncWebServerRequest* request, const std::function<Response(Request&)>& handler);
+    Response executeMiddleware(const Route& route, Request& request, const std::function<Response(Request&)>& handler);
+    Response executeCoalesced(const Route& route, Request& request, const std::function<Response(Request&)>& handler);
+    void expireCoalescedResults(unsigned long now);
     WebSocketRoute* currentWsRoute = nullptr; // For chaining WebSocket handlers
 };
 
@@ -0,0 +1,12 @@
+#include "View.h"
+#include "../Core/Application.h"
+#include "../Routing/Router.h"
+
+String View::route(const String& name, const std::map<String, String>& parameters) {
+    // Resolve through the application router's named-route index
+    Router* router = Application::getInstance()->getRouter();
+    if (!router) {
+        return "";
+    }
+    return router->route(name, parameters);
+}
@@ -0,0 +1,54 @@
+// Minimal check and timing helpers shared by the host tests and benchmarks
+#pragma once
+#include <Arduino.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static int hostFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            hostFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        auto actualValue = (actual); \
+        auto expectedValue = (expected); \
+        if (!(actualValue == expectedValue)) { \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed\n", __FILE__, __LINE__, #actual, #expected); \
+            hostFailures++; \
+        } \
+    } while (0)
+
+inline int finishTests(const char* name) {
+    if (hostFailures == 0) {
+        printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    printf("%s: %d check(s) failed\n", name, hostFailures);
+    return 1;
+}
+
+// --quick shrinks benchmarks to a smoke run under ctest
+inline bool quickRun(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) return true;
+    }
+    return false;
+}
+
+// Nanoseconds per call of fn, over iterations calls
+template<typename Fn>
+double nanosPerCall(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
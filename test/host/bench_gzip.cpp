@@ -0,0 +1,98 @@
+// On-the-fly gzip: encoder CPU time against bytes saved on typical API payloads.
+// Output is inflated with zlib when it is available to check the stream round-trips.
+#include "HostTest.h"
+#include <Http/GzipEncoder.h>
+#include <vector>
+#ifdef HOST_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Bytes the connection asks for at a time (one TCP segment)
+static const size_t CHUNK = 1436;
+
+static String servoListing(int count) {
+    String json = "{\"success\":true,\"servo_count\":" + String(count) + ",\"servos\":[";
+    for (int i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += "{\"pin\":" + String(12 + i) + ",\"name\":\"Servo " + String(i) + "\",\"current_angle\":" + String((i * 37) % 181) +
+                ",\"is_attached\":true,\"is_enabled\":" + String(i % 3 ? "true" : "false") + ",\"last_update\":" + String(100000 + i * 7919) + "}";
+    }
+    return json + "]}";
+}
+
+static String systemStats() {
+    return "{\"success\":true,\"system\":{\"uptime\":8462113,\"free_heap\":183220,\"min_free_heap\":151004,"
+           "\"largest_block\":110580,\"psram_free\":4093812,\"cpu_freq_mhz\":240,\"chip_model\":\"ESP32-S3\","
+           "\"sdk_version\":\"v5.1.4\",\"flash_size\":8388608},\"network\":{\"ssid\":\"workshop\",\"rssi\":-61,"
+           "\"ip\":\"192.168.1.20\",\"mac\":\"24:0A:C4:12:34:56\"},\"http\":{\"route_cache_hits\":10233,"
+           "\"route_cache_misses\":311,\"coalesced_requests\":42,\"response_cache_hits\":991,\"in_flight\":1,"
+           "\"rejected\":0},\"camera\":{\"frame_size\":\"VGA\",\"quality\":12,\"fps\":14.2}}";
+}
+
+static String configurationList(int count) {
+    String json = "{\"success\":true,\"configurations\":[";
+    for (int i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += "{\"id\":" + String(i + 1) + ",\"key\":\"setting_" + String(i) + "\",\"value\":\"" + String(i * 13) +
+                "\",\"type\":\"integer\",\"created_at\":\"2026-01-01T00:00:00Z\",\"updated_at\":\"2026-01-0" + String(1 + i % 9) + "T12:00:00Z\"}";
+    }
+    return json + "]}";
+}
+
+static std::vector<uint8_t> compress(const String& payload) {
+    GzipEncoder encoder((const uint8_t*)payload.c_str(), payload.length());
+    CHECK(encoder.isValid());
+    std::vector<uint8_t> output;
+    uint8_t buffer[CHUNK];
+    size_t written;
+    while ((written = encoder.read(buffer, sizeof(buffer))) > 0) {
+        output.insert(output.end(), buffer, buffer + written);
+    }
+    return output;
+}
+
+static void checkRoundTrip(const String& payload, const std::vector<uint8_t>& compressed) {
+#ifdef HOST_HAVE_ZLIB
+    std::vector<uint8_t> inflated(payload.length() + 1);
+    z_stream stream = {};
+    inflateInit2(&stream, 16 + MAX_WBITS);
+    stream.next_in = (Bytef*)compressed.data();
+    stream.avail_in = compressed.size();
+    stream.next_out = inflated.data();
+    stream.avail_out = inflated.size();
+    int status = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    CHECK_EQ(status, Z_STREAM_END);
+    CHECK(stream.total_out == payload.length() && memcmp(inflated.data(), payload.c_str(), payload.length()) == 0);
+#endif
+}
+
+int main(int argc, char** argv) {
+    bool quick = quickRun(argc, argv);
+    struct Payload {
+        const char* name;
+        String body;
+    } payloads[] = {
+        {"system stats", systemStats()},
+        {"servo listing (4)", servoListing(4)},
+        {"servo listing (16)", servoListing(16)},
+        {"configurations (64)", configurationList(64)},
+    };
+    
+    printf("%-22s %8s %8s %7s %10s %9s\n", "payload", "bytes", "gzipped", "saved", "us/encode", "MB/s");
+    for (const Payload& payload : payloads) {
+        std::vector<uint8_t> compressed = compress(payload.body);
+        checkRoundTrip(payload.body, compressed);
+        
+        size_t iterations = quick ? 20 : 2000;
+        double ns = nanosPerCall(iterations, [&](size_t) {
+            compressed = compress(payload.body);
+        });
+        double saved = 100.0 * (1.0 - double(compressed.size()) / payload.body.length());
+        printf("%-22s %8u %8zu %6.1f%% %10.1f %9.1f\n", payload.name, payload.body.length(), compressed.size(),
+               saved, ns / 1000.0, payload.body.length() * 1000.0 / ns);
+        CHECK(compressed.size() < payload.body.length());
+    }
+    
+    return finishTests("bench_gzip");
+}
@@ -0,0 +1,66 @@
+// Rate limiter table at 10k distinct clients, most of them sharing a few /24 subnets
+// the way LAN and carrier-NAT traffic does
+#include "HostTest.h"
+#include <Http/Middleware.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+#include <vector>
+
+static const size_t CLIENTS = 10000;
+
+static Response allow(Request& request) {
+    return Response(request.getServerRequest()).status(200);
+}
+
+// 10.0.0.0/16 filled subnet by subnet, plus 192.168.1.0/24
+static std::vector<IPAddress> clientAddresses(size_t count) {
+    std::vector<IPAddress> addresses;
+    for (int host = 1; host < 255 && addresses.size() < count; host++) {
+        addresses.push_back(IPAddress(192, 168, 1, host));
+    }
+    for (size_t i = 0; addresses.size() < count; i++) {
+        addresses.push_back(IPAddress(10, 0, (i / 250) % 256, 1 + i % 250));
+    }
+    return addresses;
+}
+
+static int statusFor(RateLimitMiddleware& limiter, AsyncWebServerRequest& serverRequest, IPAddress address) {
+    serverRequest.setRemoteIP(address);
+    Request request(&serverRequest);
+    std::function<Response(Request&)> handler = allow;
+    Middleware* pipeline[] = {&limiter};
+    MiddlewareChain chain(pipeline, 1, handler);
+    return chain(request).getStatusCode();
+}
+
+int main(int argc, char** argv) {
+    bool quick = quickRun(argc, argv);
+    std::vector<IPAddress> addresses = clientAddresses(quick ? 2000 : CLIENTS);
+    AsyncWebServerRequest serverRequest(HTTP_GET, "/api/v1/servos");
+    
+    // Every client in one subnet keeps its own bucket
+    RateLimitMiddleware subnet(2, 60000, 256);
+    for (int host = 1; host < 255; host++) {
+        CHECK_EQ(statusFor(subnet, serverRequest, IPAddress(192, 168, 1, host)), 200);
+        CHECK_EQ(statusFor(subnet, serverRequest, IPAddress(192, 168, 1, host)), 200);
+    }
+    CHECK_EQ(subnet.getClientCount(), (size_t)254);
+    CHECK_EQ(statusFor(subnet, serverRequest, IPAddress(192, 168, 1, 7)), 429);
+    CHECK_EQ(statusFor(subnet, serverRequest, IPAddress(192, 168, 1, 8)), 429);
+    
+    // A table sized for every client, and the default 128 that evicts on most requests
+    const size_t capacities[] = {CLIENTS + CLIENTS / 4, 128};
+    size_t rounds = quick ? 2 : 20;
+    printf("%zu clients, %zu requests each\n", addresses.size(), rounds);
+    printf("%10s %10s %10s %10s\n", "capacity", "ns/req", "tracked", "evictions");
+    for (size_t capacity : capacities) {
+        RateLimitMiddleware limiter(1000000, 60000, capacity);
+        double ns = nanosPerCall(addresses.size() * rounds, [&](size_t i) {
+            statusFor(limiter, serverRequest, addresses[i % addresses.size()]);
+        });
+        printf("%10zu %10.0f %10zu %10lu\n", capacity, ns, limiter.getClientCount(), limiter.getEvictions());
+        CHECK(limiter.getClientCount() <= capacity);
+    }
+    
+    return finishTests("bench_ratelimit");
+}
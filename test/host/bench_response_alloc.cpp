@@ -0,0 +1,113 @@
+// Heap allocations per request through the CORS, JSON and logging middleware, for the
+// move-only Response against a model of the copyable one it replaced
+#include "HostTest.h"
+#include <Http/Middleware.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+#include <cstdlib>
+#include <map>
+#include <new>
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+static const char* PAYLOAD = "{\"temperature\":21.5,\"humidity\":48,\"uptime\":123456,\"heap\":183220,\"status\":\"ok\"}";
+
+// The previous Response: headers in a std::map, builders returning Response& (so every
+// `return Response(...).header(...)` copied), and getContent() returning the body by value
+struct LegacyResponse {
+    int statusCode = 200;
+    String type = "text/html";
+    String body;
+    std::map<String, String> headers;
+    
+    LegacyResponse& status(int code) { statusCode = code; return *this; }
+    LegacyResponse& header(const String& name, const String& value) { headers[name] = value; return *this; }
+    LegacyResponse& json(const String& data) { body = data; type = "application/json"; return *this; }
+    LegacyResponse& contentType(const String& value) { type = value; return *this; }
+    String getContent() const { return body; }
+    String getContentType() const { return type; }
+};
+
+static LegacyResponse legacyHandler() {
+    return LegacyResponse().status(200).header("Cache-Control", "no-store").json(PAYLOAD);
+}
+
+static LegacyResponse legacyJson() {
+    LegacyResponse response = legacyHandler();
+    if (response.getContentType() == "text/html" && response.getContent().startsWith("{")) {
+        response.contentType("application/json");
+    }
+    return response;
+}
+
+static LegacyResponse legacyCors(const String& origins, const String& methods, const String& headers) {
+    LegacyResponse response = legacyJson();
+    response.header("Access-Control-Allow-Origin", origins)
+            .header("Access-Control-Allow-Methods", methods)
+            .header("Access-Control-Allow-Headers", headers);
+    return response;
+}
+
+static LegacyResponse legacyLogging(Request& request, const String& origins, const String& methods, const String& headers) {
+    Serial.printf("[%lu] %s %s from %s\n", millis(), httpMethodName(request.httpMethod()), request.path().c_str(), request.ip().c_str());
+    LegacyResponse response = legacyCors(origins, methods, headers);
+    Serial.printf("[%lu] Response: %d\n", millis(), response.statusCode);
+    return response;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = quickRun(argc, argv) ? 1000 : 100000;
+    
+    CorsMiddleware cors;
+    JsonMiddleware json;
+    LoggingMiddleware logging;
+    Middleware* pipeline[] = {&logging, &cors, &json};
+    std::function<Response(Request&)> handler = [](Request& request) {
+        return Response(request.getServerRequest()).status(200).header("Cache-Control", "no-store").json(String(PAYLOAD));
+    };
+    
+    AsyncWebServerRequest serverRequest(HTTP_GET, "/api/v1/system/stats");
+    serverRequest.setRemoteIP(IPAddress(192, 168, 1, 20));
+    
+    // Middleware and handler only; Request setup and send() are the same for both
+    Request request(&serverRequest);
+    size_t start = allocations;
+    for (size_t i = 0; i < iterations; i++) {
+        MiddlewareChain chain(pipeline, 3, handler);
+        Response response = chain(request);
+        CHECK_EQ(response.getStatusCode(), 200);
+    }
+    double current = double(allocations - start) / iterations;
+    
+    String origins = "*";
+    String methods = "GET,POST,PUT,DELETE,PATCH,OPTIONS";
+    String headers = "Content-Type,Authorization";
+    start = allocations;
+    for (size_t i = 0; i < iterations; i++) {
+        LegacyResponse response = legacyLogging(request, origins, methods, headers);
+        CHECK_EQ(response.statusCode, 200);
+    }
+    double legacy = double(allocations - start) / iterations;
+    
+    printf("allocations per request\n");
+    printf("%-22s %6.1f\n", "copyable map headers", legacy);
+    printf("%-22s %6.1f\n", "move-only inline", current);
+    CHECK(current < legacy);
+    
+    return finishTests("bench_response_alloc");
+}
@@ -0,0 +1,70 @@
+// Route cache: lookup latency on a hit, on a miss, and with the cache disabled
+#include "HostTest.h"
+#include <Routing/Router.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+#include <vector>
+
+static const size_t ROUTE_COUNT = 200;
+static const size_t CACHE_CAPACITY = 16;
+
+static Response emptyHandler(Request&) {
+    return Response(nullptr);
+}
+
+// Polled endpoints look like /api/v1/sensors/{id}/readings/{channel}
+static void registerRoutes(Router& router) {
+    for (size_t i = 0; i < ROUTE_COUNT; i++) {
+        router.get("/api/v1/group" + String((int)i) + "/sensors/{id}/readings/{channel}", emptyHandler);
+    }
+}
+
+static std::vector<String> makePaths(size_t count) {
+    std::vector<String> paths;
+    for (size_t i = 0; i < count; i++) {
+        paths.push_back("/api/v1/group" + String((int)((i * 7) % ROUTE_COUNT)) + "/sensors/" + String((int)i) + "/readings/temp");
+    }
+    return paths;
+}
+
+static double measure(Router& router, const std::vector<String>& paths, size_t iterations) {
+    size_t found = 0;
+    double ns = nanosPerCall(iterations, [&](size_t i) {
+        RouteMatch match;
+        found += router.resolveRoute(METHOD_GET, paths[i % paths.size()], match) != nullptr;
+    });
+    CHECK_EQ(found, iterations);
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = quickRun(argc, argv) ? 5000 : 1000000;
+    
+    AsyncWebServer server(80);
+    Router router(&server);
+    registerRoutes(router);
+    router.init();
+    
+    // Working set that fits the cache, and one that cycles through four times its capacity
+    std::vector<String> hotPaths = makePaths(CACHE_CAPACITY / 2);
+    std::vector<String> coldPaths = makePaths(CACHE_CAPACITY * 4);
+    
+    double uncachedNs = measure(router, hotPaths, iterations);
+    
+    router.enableRouteCache(CACHE_CAPACITY);
+    router.resetRouteCacheStats();
+    double hitNs = measure(router, hotPaths, iterations);
+    CHECK_EQ(router.getRouteCacheMisses(), (uint32_t)hotPaths.size());
+    
+    router.clearRouteCache();
+    router.resetRouteCacheStats();
+    double missNs = measure(router, coldPaths, iterations);
+    CHECK_EQ(router.getRouteCacheHits(), 0u);
+    
+    printf("%zu routes, cache capacity %zu\n", ROUTE_COUNT, CACHE_CAPACITY);
+    printf("%-12s %10.0f ns/lookup\n", "uncached", uncachedNs);
+    printf("%-12s %10.0f ns/lookup\n", "cache hit", hitNs);
+    printf("%-12s %10.0f ns/lookup\n", "cache miss", missNs);
+    
+    return finishTests("bench_route_cache");
+}
@@ -0,0 +1,142 @@
+// Route lookup: the compiled per-method tries against the linear scan they replaced,
+// at 50, 500 and 5000 registered routes
+#include "HostTest.h"
+#include <Routing/Router.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+#include <map>
+#include <random>
+#include <vector>
+
+// The lookup Router::handleRequest did before the tries: a linear scan with String compares,
+// re-splitting pattern and path into segments for every parametric candidate
+struct LegacyRoute {
+    String method;
+    String path;
+};
+
+static void splitSegments(const String& path, std::vector<String>& segments) {
+    String copy = path;
+    if (copy.startsWith("/")) copy = copy.substring(1);
+    if (copy.endsWith("/")) copy = copy.substring(0, copy.length() - 1);
+    
+    int start = 0;
+    for (int i = 0; i <= (int)copy.length(); i++) {
+        if (i == (int)copy.length() || copy.charAt(i) == '/') {
+            if (i > start) segments.push_back(copy.substring(start, i));
+            start = i + 1;
+        }
+    }
+}
+
+static bool legacyMatch(const LegacyRoute& route, const String& method, const String& path, std::map<String, String>& params) {
+    if (route.method != method) return false;
+    if (route.path == path) return true;
+    if (route.path.indexOf('{') < 0) return false;
+    
+    std::vector<String> routeSegments;
+    std::vector<String> pathSegments;
+    splitSegments(route.path, routeSegments);
+    splitSegments(path, pathSegments);
+    if (routeSegments.size() != pathSegments.size()) return false;
+    
+    for (size_t i = 0; i < routeSegments.size(); i++) {
+        String routeSegment = routeSegments[i];
+        String pathSegment = pathSegments[i];
+        if (routeSegment.startsWith("{") && routeSegment.endsWith("}")) {
+            params[routeSegment.substring(1, routeSegment.length() - 1)] = pathSegment;
+        } else if (routeSegment != pathSegment) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const LegacyRoute* legacyLookup(const std::vector<LegacyRoute>& routes, const String& method, const String& path,
+                                       std::map<String, String>& params) {
+    for (const LegacyRoute& route : routes) {
+        if (route.method == method && route.path == path) return &route;
+    }
+    for (const LegacyRoute& route : routes) {
+        if (route.method == method && route.path.indexOf('{') >= 0) {
+            std::map<String, String> scratch;
+            if (legacyMatch(route, method, path, scratch)) {
+                // The old dispatch matched a second time to extract the parameters
+                legacyMatch(route, method, path, params);
+                return &route;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// Half static routes, half with one {id} segment, spread over a few groups like /api/v1
+static String routePattern(size_t i) {
+    String base = "/api/v1/group" + String((int)(i % 8)) + "/resource" + String((int)i);
+    return i % 2 == 0 ? base : base + "/{id}";
+}
+
+static String requestPath(size_t i) {
+    String base = "/api/v1/group" + String((int)(i % 8)) + "/resource" + String((int)i);
+    return i % 2 == 0 ? base : base + "/42";
+}
+
+int main(int argc, char** argv) {
+    bool quick = quickRun(argc, argv);
+    const size_t sizes[] = {50, 500, 5000};
+    
+    printf("%8s %14s %14s %8s\n", "routes", "legacy ns/op", "trie ns/op", "speedup");
+    for (size_t count : sizes) {
+        if (quick && count > 500) break;
+        
+        AsyncWebServer server(80);
+        Router router(&server);
+        std::vector<LegacyRoute> legacy;
+        for (size_t i = 0; i < count; i++) {
+            router.get(routePattern(i), [](Request&) { return Response(nullptr); });
+            legacy.push_back({"GET", routePattern(i)});
+        }
+        router.init();
+        
+        // Requests spread uniformly over the registered routes
+        std::mt19937 generator(1);
+        std::vector<String> paths;
+        for (size_t i = 0; i < 1024; i++) {
+            paths.push_back(requestPath(generator() % count));
+        }
+        
+        size_t iterations = quick ? 2000 : (count >= 5000 ? 20000 : 200000);
+        size_t legacyFound = 0;
+        double legacyNs = nanosPerCall(quick ? iterations / 10 : iterations / (count / 50), [&](size_t i) {
+            std::map<String, String> params;
+            legacyFound += legacyLookup(legacy, "GET", paths[i % paths.size()], params) != nullptr;
+        });
+        
+        size_t trieFound = 0;
+        double trieNs = nanosPerCall(iterations, [&](size_t i) {
+            RouteMatch match;
+            const Route* route = router.resolveRoute(METHOD_GET, paths[i % paths.size()], match);
+            trieFound += route != nullptr;
+        });
+        
+        CHECK(legacyFound > 0);
+        CHECK(trieFound > 0);
+        printf("%8zu %14.0f %14.0f %7.1fx\n", count, legacyNs, trieNs, legacyNs / trieNs);
+    }
+    
+    // Both matchers agree on the route and its parameter
+    AsyncWebServer server(80);
+    Router router(&server);
+    router.get("/api/v1/servo/{pin}/angle", [](Request&) { return Response(nullptr); });
+    router.get("/api/v1/servo/list", [](Request&) { return Response(nullptr); });
+    router.init();
+    RouteMatch match;
+    String path = "/api/v1/servo/12/angle";
+    const Route* route = router.resolveRoute(METHOD_GET, path, match);
+    CHECK(route != nullptr && route->path == "/api/v1/servo/{pin}/angle");
+    CHECK_EQ(match.paramCount, 1);
+    CHECK(match.paramCount == 1 && String(match.params[0].value, match.params[0].length) == "12");
+    CHECK(router.resolveRoute(METHOD_POST, "/api/v1/servo/list", match) == nullptr);
+    
+    return finishTests("bench_router");
+}
@@ -0,0 +1,111 @@
+// Peak heap against payload size for a listing sent as one String body and through
+// Response::stream(), from the handler until the last byte has left through the connection
+#include "HostTest.h"
+#include <Http/Response.h>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+static size_t heapInUse = 0;
+static size_t heapPeak = 0;
+
+// Each block records its size in front of the pointer handed out, so delete can account for it
+static const size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    uint8_t* block = (uint8_t*)malloc(size + HEADER);
+    if (!block) throw std::bad_alloc();
+    *(size_t*)block = size;
+    heapInUse += size;
+    if (heapInUse > heapPeak) heapPeak = heapInUse;
+    return block + HEADER;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    uint8_t* block = (uint8_t*)pointer - HEADER;
+    heapInUse -= *(size_t*)block;
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+static const size_t ROW_SIZE = 64;
+
+// One fixed-width listing row, so any payload size maps to a whole number of rows
+static void formatRow(char* line, size_t row) {
+    snprintf(line, ROW_SIZE + 1, "{\"id\":%8u,\"name\":\"servo-%08u\",\"pin\":%2u,\"angle\":%6u}\n",
+             (unsigned)row, (unsigned)row, (unsigned)(row % 40), (unsigned)(row % 181));
+}
+
+static Response buffered(AsyncWebServerRequest* request, size_t rows) {
+    String body;
+    char line[ROW_SIZE + 1];
+    for (size_t row = 0; row < rows; row++) {
+        formatRow(line, row);
+        body += line;
+    }
+    return Response(request).status(200).text(body);
+}
+
+static Response streamed(AsyncWebServerRequest* request, size_t rows) {
+    struct Listing {
+        size_t row = 0;
+        size_t offset = ROW_SIZE; // Position in line; starts exhausted
+        char line[ROW_SIZE + 1];
+    };
+    std::shared_ptr<Listing> listing = std::make_shared<Listing>();
+    
+    return Response(request).status(200).stream("text/plain", [listing, rows](uint8_t* buffer, size_t maxLen, size_t) -> size_t {
+        size_t written = 0;
+        while (written < maxLen) {
+            if (listing->offset == ROW_SIZE) {
+                if (listing->row == rows) break;
+                formatRow(listing->line, listing->row++);
+                listing->offset = 0;
+            }
+            size_t count = std::min(maxLen - written, ROW_SIZE - listing->offset);
+            memcpy(buffer + written, listing->line + listing->offset, count);
+            listing->offset += count;
+            written += count;
+        }
+        return written;
+    });
+}
+
+// Peak bytes allocated above the starting level while building, sending and draining one response
+template<typename Build>
+static size_t peakHeap(size_t rows, size_t& sent, Build build) {
+    size_t base = heapInUse;
+    heapPeak = base;
+    {
+        AsyncWebServerRequest request(HTTP_GET, "/api/v1/servos/export");
+        build(&request, rows).send();
+        sent = request.sent ? request.sent->discard() : 0;
+    }
+    return heapPeak - base;
+}
+
+int main(int argc, char** argv) {
+    static const size_t SIZES[] = {4096, 65536, 524288, 4194304};
+    size_t count = quickRun(argc, argv) ? 2 : 4;
+    
+    printf("%10s %14s %14s\n", "payload", "String peak", "stream peak");
+    for (size_t i = 0; i < count; i++) {
+        size_t rows = SIZES[i] / ROW_SIZE;
+        size_t bufferedSent = 0;
+        size_t streamedSent = 0;
+        size_t bufferedPeak = peakHeap(rows, bufferedSent, buffered);
+        size_t streamedPeak = peakHeap(rows, streamedSent, streamed);
+        printf("%10u %14u %14u\n", (unsigned)SIZES[i], (unsigned)bufferedPeak, (unsigned)streamedPeak);
+        
+        CHECK_EQ(bufferedSent, SIZES[i]);
+        CHECK_EQ(streamedSent, SIZES[i]);
+        CHECK(bufferedPeak >= SIZES[i]);
+        CHECK(streamedPeak < 8192);
+    }
+    
+    return finishTests("bench_stream_heap");
+}
@@ -0,0 +1,245 @@
+// Host stand-in for the parts of the Arduino-ESP32 core used by the framework sources
+#pragma once
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <cstdarg>
+#include <ctime>
+#include <algorithm>
+#include <utility>
+#include <memory>
+#include <type_traits>
+
+typedef bool boolean;
+class __FlashStringHelper;
+#define F(x) x
+#define PROGMEM
+#define ARDUINO 10800
+#define HEX 16
+#define DEC 10
+
+inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+inline bool isAlphaNumeric(int c) { return isalnum(c) != 0; }
+
+class String {
+    std::string s;
+    
+    static std::string format(unsigned long long value, unsigned char base, bool negative) {
+        if (value == 0) return "0";
+        std::string out;
+        while (value > 0) {
+            out.insert(out.begin(), "0123456789abcdef"[value % base]);
+            value /= base;
+        }
+        return negative ? "-" + out : out;
+    }
+    static std::string format(long long value, unsigned char base) {
+        return value < 0 ? format((unsigned long long)-value, base, true) : format((unsigned long long)value, base, false);
+    }
+
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const char* c, unsigned int n) : s(c, n) {}
+    String(const std::string& c) : s(c) {}
+    explicit String(char c) : s(1, c) {}
+    String(int v, unsigned char base = 10) : s(format((long long)v, base)) {}
+    String(unsigned int v, unsigned char base = 10) : s(format((unsigned long long)v, base, false)) {}
+    String(long v, unsigned char base = 10) : s(format((long long)v, base)) {}
+    String(unsigned long v, unsigned char base = 10) : s(format((unsigned long long)v, base, false)) {}
+    String(long long v, unsigned char base = 10) : s(format(v, base)) {}
+    String(unsigned long long v, unsigned char base = 10) : s(format(v, base, false)) {}
+    String(float v, unsigned int d = 2) : String((double)v, d) {}
+    String(double v, unsigned int d = 2) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", (int)d, v);
+        s = buffer;
+    }
+    
+    unsigned int length() const { return s.size(); }
+    const char* c_str() const { return s.c_str(); }
+    char* begin() { return &s[0]; }
+    char* end() { return &s[0] + s.size(); }
+    const char* begin() const { return s.data(); }
+    const char* end() const { return s.data() + s.size(); }
+    bool reserve(unsigned int n) { s.reserve(n); return true; }
+    bool isEmpty() const { return s.empty(); }
+    explicit operator bool() const { return true; }
+    char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    char& operator[](unsigned int i) { return s[i]; }
+    char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    void setCharAt(unsigned int i, char c) { if (i < s.size()) s[i] = c; }
+    
+    String& operator+=(const String& o) { s += o.s; return *this; }
+    String& operator+=(const char* o) { s += o; return *this; }
+    String& operator+=(char o) { s += o; return *this; }
+    String& operator+=(int o) { s += String(o).s; return *this; }
+    String& operator+=(unsigned int o) { s += String(o).s; return *this; }
+    String& operator+=(long o) { s += String(o).s; return *this; }
+    String& operator+=(unsigned long o) { s += String(o).s; return *this; }
+    bool concat(const char* c, unsigned int n) { s.append(c, n); return true; }
+    bool concat(const String& c) { s += c.s; return true; }
+    bool concat(const char* c) { s += c; return true; }
+    bool concat(char c) { s += c; return true; }
+    
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.s); }
+    friend String operator+(const String& a, char b) { return String(a.s + b); }
+    friend String operator+(const String& a, int b) { return a + String(b); }
+    friend String operator+(const String& a, unsigned long b) { return a + String(b); }
+    
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator==(const char* o) const { return s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return s != o.s; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    bool operator<(const String& o) const { return s < o.s; }
+    bool equals(const String& o) const { return s == o.s; }
+    bool equalsIgnoreCase(const String& o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+    int compareTo(const String& o) const { return s.compare(o.s); }
+    bool startsWith(const String& p) const { return s.compare(0, p.s.size(), p.s) == 0 && s.size() >= p.s.size(); }
+    bool startsWith(const String& p, unsigned int off) const { return off <= s.size() && s.compare(off, p.s.size(), p.s) == 0 && s.size() - off >= p.s.size(); }
+    bool endsWith(const String& p) const { return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0; }
+    
+    int indexOf(char c, unsigned int from = 0) const { auto r = s.find(c, from); return r == std::string::npos ? -1 : (int)r; }
+    int indexOf(const String& c, unsigned int from = 0) const { auto r = s.find(c.s, from); return r == std::string::npos ? -1 : (int)r; }
+    int lastIndexOf(char c) const { auto r = s.rfind(c); return r == std::string::npos ? -1 : (int)r; }
+    int lastIndexOf(const String& c) const { auto r = s.rfind(c.s); return r == std::string::npos ? -1 : (int)r; }
+    String substring(unsigned int a) const { return a >= s.size() ? String() : String(s.substr(a)); }
+    String substring(unsigned int a, unsigned int b) const {
+        if (a > b) std::swap(a, b);
+        if (a >= s.size()) return String();
+        return String(s.substr(a, std::min<size_t>(b, s.size()) - a));
+    }
+    
+    void replace(const String& a, const String& b) {
+        if (a.s.empty()) return;
+        for (size_t at = s.find(a.s); at != std::string::npos; at = s.find(a.s, at + b.s.size())) {
+            s.replace(at, a.s.size(), b.s);
+        }
+    }
+    void replace(char a, char b) { std::replace(s.begin(), s.end(), a, b); }
+    void remove(unsigned int i) { if (i < s.size()) s.erase(i); }
+    void remove(unsigned int i, unsigned int n) { if (i < s.size()) s.erase(i, n); }
+    void toLowerCase() { for (char& c : s) c = tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : s) c = toupper((unsigned char)c); }
+    void trim() {
+        size_t first = s.find_first_not_of(" \t\r\n");
+        size_t last = s.find_last_not_of(" \t\r\n");
+        s = first == std::string::npos ? "" : s.substr(first, last - first + 1);
+    }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    void getBytes(unsigned char* b, unsigned int n) const {
+        if (n == 0) return;
+        size_t count = std::min<size_t>(n - 1, s.size());
+        memcpy(b, s.data(), count);
+        b[count] = 0;
+    }
+    
+    size_t write(uint8_t c) { s += (char)c; return 1; }
+    size_t write(const uint8_t* b, size_t n) { s.append((const char*)b, n); return n; }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t* b, size_t n) { for (size_t i = 0; i < n; i++) write(b[i]); return n; }
+    size_t print(const String& v) { return write((const uint8_t*)v.c_str(), v.length()); }
+    size_t print(const char* v) { return write((const uint8_t*)v, strlen(v)); }
+    size_t print(int v) { return print(String(v)); }
+    size_t println(const String& v = "") { return print(v) + print("\n"); }
+    size_t println(const char* v) { return print(v) + print("\n"); }
+    size_t println(int v) { return print(String(v)) + print("\n"); }
+    size_t println(unsigned long v) { return print(String(v)) + print("\n"); }
+    size_t printf(const char* format, ...) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        return length > 0 ? write((const uint8_t*)buffer, std::min<size_t>(length, sizeof(buffer) - 1)) : 0;
+    }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        for (int c; count < length && (c = read()) >= 0; count++) buffer[count] = (uint8_t)c;
+        return count;
+    }
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+    String readString() {
+        String out;
+        for (int c; (c = read()) >= 0;) out += (char)c;
+        return out;
+    }
+    String readStringUntil(char terminator) {
+        String out;
+        for (int c; (c = read()) >= 0 && c != terminator;) out += (char)c;
+        return out;
+    }
+};
+
+// Output is dropped unless Serial.echo is set
+class HardwareSerial : public Stream {
+public:
+    bool echo = false;
+    void begin(int) {}
+    size_t write(uint8_t c) override { if (echo) fputc(c, stdout); return 1; }
+};
+extern HardwareSerial Serial;
+
+template<typename A, typename B> typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+template<typename A, typename B> typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+bool psramFound();
+void* ps_malloc(size_t size);
+
+// Heap figures are whatever the host test sets
+class EspClass {
+public:
+    uint32_t freeHeap = 200000;
+    uint32_t maxAllocHeap = 100000;
+    uint32_t getFreeHeap() { return freeHeap; }
+    uint32_t getMaxAllocHeap() { return maxAllocHeap; }
+    uint32_t getHeapSize() { return 320000; }
+    uint32_t getMinFreeHeap() { return freeHeap; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getPsramSize() { return 0; }
+    void restart() {}
+};
+extern EspClass ESP;
+
+// Same layout as arduino-esp32: the first octet is the least significant byte
+class IPAddress {
+    uint32_t address = 0;
+public:
+    IPAddress() {}
+    IPAddress(uint32_t value) : address(value) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    operator uint32_t() const { return address; }
+    uint8_t operator[](int i) const { return (address >> (i * 8)) & 0xff; }
+    String toString() const {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return buffer;
+    }
+};
+
+#include "esp_heap_caps.h"
+#include "FS.h"
+
+extern "C" uint32_t esp_random(void);
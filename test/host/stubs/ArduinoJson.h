@@ -0,0 +1,51 @@
+#pragma once
+// Host stand-in for ArduinoJson 7: documents compile but hold no data, so JSON payloads are empty
+#include "Arduino.h"
+namespace ArduinoJson {
+class Allocator { public: virtual void* allocate(size_t) = 0; virtual void deallocate(void*) = 0; virtual void* reallocate(void*, size_t) = 0; protected: ~Allocator() = default; };
+}
+class JsonObject; class JsonArray;
+class JsonVariant {
+public:
+  template<typename T> JsonVariant& operator=(const T&) { return *this; }
+  JsonVariant operator[](const char*) const { return JsonVariant(); }
+  JsonVariant operator[](const String&) const { return JsonVariant(); }
+  JsonVariant operator[](int) const { return JsonVariant(); }
+  template<typename T> T as() const { return T(); }
+  template<typename T> bool is() const { return false; }
+  template<typename T> operator T() const { return T(); }
+  template<typename T> T add() { return T(); }
+  template<typename T> bool add(const T&) { return true; }
+  bool isNull() const { return true; }
+  template<typename T> bool containsKey(const T&) const { return false; }
+  template<typename T> bool operator==(const T&) const { return false; }
+  size_t size() const { return 0; }
+};
+typedef JsonVariant JsonVariantConst;
+class JsonString { public: const char* c_str() const { return ""; } };
+class JsonPair { public: JsonString key() const { return JsonString(); } JsonVariant value() const { return JsonVariant(); } };
+typedef JsonPair JsonPairConst;
+class JsonObject : public JsonVariant { public: JsonPair* begin() const { return nullptr; } JsonPair* end() const { return nullptr; } };
+typedef JsonObject JsonObjectConst;
+class JsonArray : public JsonVariant { public: JsonVariant* begin() const { return nullptr; } JsonVariant* end() const { return nullptr; } };
+class JsonDocument : public JsonVariant {
+public:
+  JsonDocument() {}
+  explicit JsonDocument(ArduinoJson::Allocator*) {}
+  JsonDocument(const JsonDocument&) = default;
+  JsonDocument(JsonDocument&&) = default;
+  JsonDocument& operator=(const JsonDocument&) = default;
+  JsonDocument& operator=(JsonDocument&&) = default;
+  template<typename T> JsonDocument& operator=(const T&) { return *this; }
+  void clear() {}
+  bool overflowed() const { return false; }
+  template<typename T> T to() { return T(); }
+};
+class DeserializationError { public: enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep }; DeserializationError(Code c = Ok) : c_(c) {} explicit operator bool() const { return c_ != Ok; } const char* c_str() const { return ""; } Code code() const { return c_; } Code c_; };
+template<typename D, typename I> DeserializationError deserializeJson(D&, const I&) { return DeserializationError(); }
+template<typename D> DeserializationError deserializeJson(D&, const char*, size_t) { return DeserializationError(); }
+template<typename D> DeserializationError deserializeJson(D&, const uint8_t*, size_t) { return DeserializationError(); }
+template<typename S> size_t serializeJson(const JsonVariant&, S&) { return 0; }
+inline size_t serializeJson(const JsonVariant&, char*, size_t) { return 0; }
+inline size_t serializeJson(const JsonVariant&, uint8_t*, size_t) { return 0; }
+inline size_t measureJson(const JsonVariant&) { return 0; }
@@ -0,0 +1,218 @@
+// Host stand-in for ESPAsyncWebServer 3.x. Requests are built by tests; responses keep their
+// payload and filler so a test can read back exactly what would go on the wire.
+#pragma once
+#include "Arduino.h"
+#include "FS.h"
+#include <functional>
+#include <vector>
+
+typedef enum {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncClient {
+public:
+    IPAddress address;
+    IPAddress remoteIP() const { return address; }
+};
+
+class AsyncWebHeader {
+    String headerName;
+    String headerValue;
+public:
+    AsyncWebHeader(const String& name, const String& value) : headerName(name), headerValue(value) {}
+    const String& name() const { return headerName; }
+    const String& value() const { return headerValue; }
+};
+
+class AsyncWebParameter {
+    String paramName;
+    String paramValue;
+    bool post;
+    bool file;
+public:
+    AsyncWebParameter(const String& name, const String& value, bool post = false, bool file = false)
+        : paramName(name), paramValue(value), post(post), file(file) {}
+    const String& name() const { return paramName; }
+    const String& value() const { return paramValue; }
+    size_t size() const { return paramValue.length(); }
+    bool isPost() const { return post; }
+    bool isFile() const { return file; }
+};
+
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+
+class AsyncWebServerResponse {
+public:
+    int code = 200;
+    String contentType;
+    String content;             // Fixed payload, when there is no filler
+    AwsResponseFiller filler;   // Callback payload (chunked when length is 0)
+    size_t length = 0;
+    bool chunked = false;
+    fs::File file;
+    std::vector<std::pair<String, String>> headers;
+    
+    virtual ~AsyncWebServerResponse() {}
+    void addHeader(const String& name, const String& value, bool replace = true) {
+        if (replace) {
+            for (auto& header : headers) {
+                if (header.first.equalsIgnoreCase(name)) { header.second = value; return; }
+            }
+        }
+        headers.push_back({name, value});
+    }
+    void setCode(int value) { code = value; }
+    void setContentLength(size_t value) { length = value; }
+    void setContentType(const String& type) { contentType = type; }
+    const String* header(const String& name) const {
+        for (const auto& header : headers) {
+            if (header.first.equalsIgnoreCase(name)) return &header.second;
+        }
+        return nullptr;
+    }
+    
+    // Runs the filler the way the server does as the TCP buffer drains
+    std::string drain(size_t chunk = 1460);
+    // As drain(), but drops the bytes once written, like the socket does; returns how many were sent
+    size_t discard(size_t chunk = 1460);
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+    size_t write(uint8_t c) override { content += (char)c; return 1; }
+    size_t write(const uint8_t* buffer, size_t length) override { content.concat((const char*)buffer, length); return length; }
+};
+
+typedef std::function<void(void)> ArDisconnectHandler;
+
+class AsyncWebServerRequest {
+    WebRequestMethodComposite requestMethod = HTTP_GET;
+    String requestUrl;
+    std::vector<AsyncWebHeader> requestHeaders;
+    std::vector<AsyncWebParameter> requestParams;
+    AsyncClient requestClient;
+    ArDisconnectHandler onDisconnectHandler;
+
+public:
+    void* _tempObject = nullptr;
+    AsyncWebServerResponse* sent = nullptr; // Response handed to send()
+    
+    AsyncWebServerRequest(WebRequestMethodComposite method = HTTP_GET, const String& url = "/") : requestMethod(method), requestUrl(url) {}
+    ~AsyncWebServerRequest() { delete sent; }
+    
+    // Test setup
+    AsyncWebServerRequest& addHeader(const String& name, const String& value) { requestHeaders.emplace_back(name, value); return *this; }
+    AsyncWebServerRequest& addParam(const String& name, const String& value, bool post = false, bool file = false) { requestParams.emplace_back(name, value, post, file); return *this; }
+    AsyncWebServerRequest& setRemoteIP(IPAddress address) { requestClient.address = address; return *this; }
+    void disconnect() { if (onDisconnectHandler) onDisconnectHandler(); }
+    
+    AsyncClient* client() { return &requestClient; }
+    WebRequestMethodComposite method() const { return requestMethod; }
+    const String& url() const { return requestUrl; }
+    
+    size_t headers() const { return requestHeaders.size(); }
+    bool hasHeader(const char* name) const { return getHeader(name) != nullptr; }
+    bool hasHeader(const String& name) const { return getHeader(name.c_str()) != nullptr; }
+    const AsyncWebHeader* getHeader(const char* name) const {
+        for (const auto& header : requestHeaders) {
+            if (strcasecmp(header.name().c_str(), name) == 0) return &header;
+        }
+        return nullptr;
+    }
+    const AsyncWebHeader* getHeader(const String& name) const { return getHeader(name.c_str()); }
+    const AsyncWebHeader* getHeader(size_t index) const { return index < requestHeaders.size() ? &requestHeaders[index] : nullptr; }
+    
+    size_t params() const { return requestParams.size(); }
+    const AsyncWebParameter* getParam(size_t index) const { return index < requestParams.size() ? &requestParams[index] : nullptr; }
+    const AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false) const {
+        for (const auto& param : requestParams) {
+            if (param.name() == name && param.isPost() == post && param.isFile() == file) return &param;
+        }
+        return nullptr;
+    }
+    bool hasParam(const String& name, bool post = false, bool file = false) const { return getParam(name, post, file) != nullptr; }
+    
+    void onDisconnect(ArDisconnectHandler fn) { onDisconnectHandler = fn; }
+    
+    void send(AsyncWebServerResponse* response) { delete sent; sent = response; }
+    void send(int code, const String& type = String(), const String& content = String()) { send(beginResponse(code, type, content)); }
+    
+    AsyncWebServerResponse* beginResponse(int code, const String& type = String(), const String& content = String());
+    AsyncWebServerResponse* beginResponse(fs::FS& fs, const String& path, const String& type = String(), bool download = false);
+    AsyncWebServerResponse* beginResponse(fs::File file, const String& path, const String& type = String(), bool download = false);
+    AsyncWebServerResponse* beginResponse(const String& type, size_t length, AwsResponseFiller filler);
+    AsyncWebServerResponse* beginChunkedResponse(const String& type, AwsResponseFiller filler);
+    AsyncWebServerResponse* beginResponse_P(int code, const String& type, const uint8_t* content, size_t length);
+    AsyncResponseStream* beginResponseStream(const String& type, size_t bufferSize = 1460);
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, const String&, size_t, uint8_t*, size_t, bool)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> ArBodyHandlerFunction;
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() {}
+};
+
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef enum { WS_CONTINUATION, WS_TEXT, WS_BINARY } AwsFrameType;
+typedef struct {
+    uint8_t message_opcode;
+    uint32_t num;
+    uint8_t final;
+    uint8_t masked;
+    uint8_t opcode;
+    uint64_t len;
+    uint8_t mask[4];
+    uint64_t index;
+} AwsFrameInfo;
+
+class AsyncWebSocketClient {
+public:
+    uint32_t id() const { return 0; }
+    IPAddress remoteIP() const { return IPAddress(); }
+    AwsClientStatus status() const { return WS_CONNECTED; }
+    void text(const String&) {}
+    void binary(const uint8_t*, size_t) {}
+    void close(uint16_t = 0, const char* = nullptr) {}
+};
+
+class AsyncWebSocket;
+typedef std::function<void(AsyncWebSocket*, AsyncWebSocketClient*, AwsEventType, void*, uint8_t*, size_t)> AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+    String socketUrl;
+public:
+    AsyncWebSocket(const String& url) : socketUrl(url) {}
+    const char* url() const { return socketUrl.c_str(); }
+    void onEvent(AwsEventHandler) {}
+    void textAll(const String&) {}
+    void binaryAll(const uint8_t*, size_t) {}
+    void text(uint32_t, const String&) {}
+    void binary(uint32_t, const uint8_t*, size_t) {}
+    AsyncWebSocketClient* client(uint32_t) { return nullptr; }
+    void close(uint32_t, uint16_t = 0, const char* = nullptr) {}
+};
+
+class AsyncWebServer {
+public:
+    ArRequestHandlerFunction notFound;
+    
+    AsyncWebServer(uint16_t) {}
+    void begin() {}
+    void onNotFound(ArRequestHandlerFunction fn) { notFound = fn; }
+    void onFileUpload(ArUploadHandlerFunction) {}
+    void onRequestBody(ArBodyHandlerFunction) {}
+    AsyncWebHandler& addHandler(AsyncWebHandler* handler) { return *handler; }
+};
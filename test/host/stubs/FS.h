@@ -0,0 +1,119 @@
+// In-memory filesystem with the fs::FS / fs::File interface of arduino-esp32
+#pragma once
+#include "Arduino.h"
+#include <map>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct FileNode {
+    std::string data;
+    time_t lastWrite = 0;
+};
+
+class File : public Stream {
+    std::shared_ptr<FileNode> node;
+    String filePath;
+    size_t offset = 0;
+    bool writable = false;
+
+public:
+    File() {}
+    File(std::shared_ptr<FileNode> node, const String& path, bool writable)
+        : node(std::move(node)), filePath(path), writable(writable) {}
+    
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t length) override {
+        if (!node || !writable) return 0;
+        node->data.replace(offset, std::min(length, node->data.size() - std::min(offset, node->data.size())),
+                           (const char*)buffer, length);
+        offset += length;
+        return length;
+    }
+    int available() override { return node ? (int)(node->data.size() - std::min(offset, node->data.size())) : 0; }
+    int read() override { return available() > 0 ? (uint8_t)node->data[offset++] : -1; }
+    int peek() override { return available() > 0 ? (uint8_t)node->data[offset] : -1; }
+    size_t read(uint8_t* buffer, size_t length) {
+        size_t count = std::min(length, (size_t)available());
+        if (count > 0) memcpy(buffer, node->data.data() + offset, count);
+        offset += count;
+        return count;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) override { return read(buffer, length); }
+    bool seek(uint32_t position) {
+        if (!node || position > node->data.size()) return false;
+        offset = position;
+        return true;
+    }
+    size_t position() const { return offset; }
+    size_t size() const { return node ? node->data.size() : 0; }
+    void close() { node.reset(); }
+    void flush() {}
+    time_t getLastWrite() { return node ? node->lastWrite : 0; }
+    const char* path() const { return filePath.c_str(); }
+    const char* name() const { return filePath.c_str() + filePath.lastIndexOf('/') + 1; }
+    bool isDirectory() { return false; }
+    File openNextFile() { return File(); }
+    explicit operator bool() const { return node != nullptr; }
+};
+
+class FS {
+    std::map<std::string, std::shared_ptr<FileNode>> files;
+
+public:
+    // Counted so tests can check how often a request reaches storage
+    unsigned long opens = 0;
+    unsigned long existsCalls = 0;
+    
+    // Records the file's modification time; 0 behaves like SPIFFS, which does not keep one
+    time_t clock = 0;
+    
+    void put(const String& path, const std::string& content) {
+        auto& node = files[path.c_str()];
+        if (!node) node = std::make_shared<FileNode>();
+        node->data = content;
+        node->lastWrite = clock;
+    }
+    
+    File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+        opens++;
+        auto it = files.find(path.c_str());
+        if (mode[0] == 'w') {
+            auto node = std::make_shared<FileNode>();
+            node->lastWrite = clock;
+            files[path.c_str()] = node;
+            return File(node, path, true);
+        }
+        if (it == files.end()) return File();
+        return File(it->second, path, mode[0] == 'a');
+    }
+    File open(const char* path, const char* mode = FILE_READ, bool create = false) { return open(String(path), mode, create); }
+    
+    // Opens the file, as VFSImpl::exists() does on the device
+    bool exists(const String& path) {
+        existsCalls++;
+        opens++;
+        return files.count(path.c_str()) > 0;
+    }
+    bool exists(const char* path) { return exists(String(path)); }
+    bool remove(const String& path) { return files.erase(path.c_str()) > 0; }
+    bool rename(const String& from, const String& to) {
+        auto it = files.find(from.c_str());
+        if (it == files.end()) return false;
+        files[to.c_str()] = it->second;
+        files.erase(from.c_str());
+        return true;
+    }
+    bool mkdir(const String&) { return true; }
+    size_t fileCount() const { return files.size(); }
+    bool rmdir(const String&) { return true; }
+};
+
+}
+
+using fs::FS;
+using fs::File;
@@ -0,0 +1,10 @@
+// Test controls for the clocks seen by the framework
+#pragma once
+#include <cstdint>
+#include <ctime>
+
+// Returned by time() when nonzero; 0 passes through to the real wall clock
+extern time_t hostWallClock;
+
+// Added to millis(), micros() and esp_timer_get_time(), to move the uptime forward
+extern int64_t hostUptimeAdvance;
@@ -0,0 +1,281 @@
+// Definitions behind the host stand-in headers
+#include "Arduino.h"
+#include "ESPAsyncWebServer.h"
+#include "LittleFS.h"
+#include "SPIFFS.h"
+#include "SHA256.h"
+#include "HostClock.h"
+#include "esp_timer.h"
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+fs::LittleFSFS LittleFS;
+fs::SPIFFSFS SPIFFS;
+
+static const auto startedAt = std::chrono::steady_clock::now();
+
+time_t hostWallClock = 0;
+int64_t hostUptimeAdvance = 0;
+
+// millis(), micros() and esp_timer_get_time() read the same uptime, as on the device
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+unsigned long micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt).count() + hostUptimeAdvance;
+}
+
+// Replaces the C library's time() so tests can start with an unset clock, as the device boots
+extern "C" time_t time(time_t* out) noexcept {
+    time_t now = hostWallClock ? hostWallClock : std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (out) *out = now;
+    return now;
+}
+
+extern "C" int64_t esp_timer_get_time(void) {
+    return (int64_t)micros();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {}
+
+bool psramFound() {
+    return false;
+}
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+extern "C" void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return malloc(size);
+}
+
+extern "C" void* heap_caps_realloc(void* pointer, size_t size, uint32_t caps) {
+    return realloc(pointer, size);
+}
+
+extern "C" size_t heap_caps_get_free_size(uint32_t caps) {
+    return ESP.getFreeHeap();
+}
+
+extern "C" size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return ESP.getMaxAllocHeap();
+}
+
+extern "C" uint32_t esp_random(void) {
+    static std::mt19937 generator(12345);
+    return generator();
+}
+
+// Fake server responses
+
+std::string AsyncWebServerResponse::drain(size_t chunk) {
+    if (!filler) {
+        return std::string(content.c_str(), content.length());
+    }
+    
+    std::string out;
+    std::vector<uint8_t> buffer(chunk);
+    while (chunked || out.size() < length) {
+        size_t maxLen = chunked ? chunk : std::min(chunk, length - out.size());
+        size_t written = filler(buffer.data(), maxLen, out.size());
+        if (written == 0) break;
+        out.append((const char*)buffer.data(), written);
+    }
+    return out;
+}
+
+size_t AsyncWebServerResponse::discard(size_t chunk) {
+    if (!filler) {
+        return content.length();
+    }
+    
+    size_t sent = 0;
+    std::vector<uint8_t> buffer(chunk);
+    while (chunked || sent < length) {
+        size_t maxLen = chunked ? chunk : std::min(chunk, length - sent);
+        size_t written = filler(buffer.data(), maxLen, sent);
+        if (written == 0) break;
+        sent += written;
+    }
+    return sent;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& type, const String& content) {
+    AsyncWebServerResponse* response = new AsyncWebServerResponse();
+    response->code = code;
+    response->contentType = type;
+    response->content = content;
+    response->length = content.length();
+    return response;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(fs::FS& fs, const String& path, const String& type, bool download) {
+    return beginResponse(fs.open(path), path, type, download);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(fs::File file, const String& path, const String& type, bool download) {
+    AsyncWebServerResponse* response = new AsyncWebServerResponse();
+    response->contentType = type;
+    response->length = file.size();
+    response->file = file;
+    std::shared_ptr<fs::File> handle = std::make_shared<fs::File>(file);
+    response->filler = [handle](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+        return handle->read(buffer, maxLen);
+    };
+    return response;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(const String& type, size_t length, AwsResponseFiller filler) {
+    AsyncWebServerResponse* response = new AsyncWebServerResponse();
+    response->contentType = type;
+    response->length = length;
+    response->filler = filler;
+    return response;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& type, AwsResponseFiller filler) {
+    AsyncWebServerResponse* response = beginResponse(type, 0, filler);
+    response->chunked = true;
+    return response;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const String& type, const uint8_t* content, size_t length) {
+    AsyncWebServerResponse* response = new AsyncWebServerResponse();
+    response->code = code;
+    response->contentType = type;
+    response->content = String((const char*)content, length);
+    response->length = length;
+    return response;
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& type, size_t bufferSize) {
+    AsyncResponseStream* response = new AsyncResponseStream();
+    response->contentType = type;
+    return response;
+}
+
+// SHA-256 (FIPS 180-4) and HMAC (RFC 2104)
+
+static const uint32_t roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static uint32_t rotateRight(uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+void SHA256::reset() {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(state, initial, sizeof(state));
+    blockLength = 0;
+    totalLength = 0;
+}
+
+void SHA256::processBlock() {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 | (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25)) + ((e & f) ^ (~e & g)) + roundConstants[i] + w[i];
+        uint32_t t2 = (rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void SHA256::update(const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    totalLength += length;
+    while (length > 0) {
+        size_t count = std::min(length, BLOCK_SIZE - blockLength);
+        memcpy(block + blockLength, bytes, count);
+        blockLength += count;
+        bytes += count;
+        length -= count;
+        if (blockLength == BLOCK_SIZE) {
+            processBlock();
+            blockLength = 0;
+        }
+    }
+}
+
+void SHA256::finalize(void* hash, size_t length) {
+    uint64_t bits = totalLength * 8;
+    uint8_t padding = 0x80;
+    update(&padding, 1);
+    padding = 0;
+    while (blockLength != BLOCK_SIZE - 8) {
+        update(&padding, 1);
+    }
+    uint8_t lengthBytes[8];
+    for (int i = 0; i < 8; i++) {
+        lengthBytes[i] = bits >> (56 - i * 8);
+    }
+    update(lengthBytes, 8);
+    
+    uint8_t digest[HASH_SIZE];
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = state[i] >> 24;
+        digest[i * 4 + 1] = state[i] >> 16;
+        digest[i * 4 + 2] = state[i] >> 8;
+        digest[i * 4 + 3] = state[i];
+    }
+    memcpy(hash, digest, std::min(length, HASH_SIZE));
+}
+
+void SHA256::formatHMACKey(const void* key, size_t keyLength, uint8_t pad) {
+    uint8_t padded[BLOCK_SIZE] = {0};
+    if (keyLength > BLOCK_SIZE) {
+        reset();
+        update(key, keyLength);
+        finalize(padded, HASH_SIZE);
+    } else {
+        memcpy(padded, key, keyLength);
+    }
+    for (size_t i = 0; i < BLOCK_SIZE; i++) {
+        padded[i] ^= pad;
+    }
+    reset();
+    update(padded, BLOCK_SIZE);
+}
+
+void SHA256::resetHMAC(const void* key, size_t keyLength) {
+    formatHMACKey(key, keyLength, 0x36);
+}
+
+void SHA256::finalizeHMAC(const void* key, size_t keyLength, void* hash, size_t length) {
+    uint8_t inner[HASH_SIZE];
+    finalize(inner, HASH_SIZE);
+    formatHMACKey(key, keyLength, 0x5c);
+    update(inner, HASH_SIZE);
+    finalize(hash, length);
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "FS.h"
+
+namespace fs {
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false) { return true; }
+};
+}
+
+extern fs::LittleFSFS LittleFS;
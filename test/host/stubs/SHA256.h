@@ -0,0 +1,27 @@
+// Host implementation of the rweather/Crypto SHA256 interface used by AuthToken
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class SHA256 {
+public:
+    static const size_t HASH_SIZE = 32;
+    static const size_t BLOCK_SIZE = 64;
+    
+    SHA256() { reset(); }
+    void reset();
+    void update(const void* data, size_t length);
+    void finalize(void* hash, size_t length);
+    void resetHMAC(const void* key, size_t keyLength);
+    void finalizeHMAC(const void* key, size_t keyLength, void* hash, size_t length);
+
+private:
+    uint32_t state[8];
+    uint8_t block[BLOCK_SIZE];
+    size_t blockLength;
+    uint64_t totalLength;
+    
+    void processBlock();
+    void formatHMACKey(const void* key, size_t keyLength, uint8_t pad);
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include "FS.h"
+
+namespace fs {
+class SPIFFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false) { return true; }
+};
+}
+
+extern fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,72 @@
+// Admission control bookkeeping, and disconnect callbacks that share one request
+#include "HostTest.h"
+#include <Http/Middleware.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+#include <LittleFS.h>
+
+void handleFileUpload(AsyncWebServerRequest* request, const String& filename, size_t index, uint8_t* data, size_t len, bool final);
+
+static Response allow(Request& request) {
+    return Response(request.getServerRequest()).status(200);
+}
+
+static int admit(AdmissionControlMiddleware& admission, AsyncWebServerRequest& serverRequest) {
+    Request request(&serverRequest);
+    std::function<Response(Request&)> handler = allow;
+    Middleware* pipeline[] = {&admission};
+    MiddlewareChain chain(pipeline, 1, handler);
+    return chain(request).getStatusCode();
+}
+
+int main() {
+    AdmissionControlMiddleware admission(2);
+    
+    // In-flight slots are given back when the connection closes
+    AsyncWebServerRequest first(HTTP_GET, "/api/v1/servos");
+    AsyncWebServerRequest second(HTTP_GET, "/api/v1/servos");
+    AsyncWebServerRequest third(HTTP_GET, "/api/v1/servos");
+    CHECK_EQ(admit(admission, first), 200);
+    CHECK_EQ(admit(admission, second), 200);
+    CHECK_EQ(admit(admission, third), 503);
+    CHECK_EQ(admission.getInFlight(), (size_t)2);
+    first.disconnect();
+    CHECK_EQ(admission.getInFlight(), (size_t)1);
+    CHECK_EQ(admit(admission, third), 200);
+    second.disconnect();
+    third.disconnect();
+    CHECK_EQ(admission.getInFlight(), (size_t)0);
+    
+    // Low heap sheds before any work starts
+    ESP.freeHeap = 16000;
+    AsyncWebServerRequest starved(HTTP_GET, "/api/v1/servos");
+    CHECK_EQ(admit(admission, starved), 503);
+    CHECK_EQ(admission.getShedForHeap(), 1ul);
+    ESP.freeHeap = 200000;
+    
+    // Callbacks registered before and after admission all run, once
+    int earlier = 0;
+    AsyncWebServerRequest shared(HTTP_GET, "/api/v1/servos");
+    Request::onDisconnect(&shared, [&earlier]() { earlier++; });
+    CHECK_EQ(admit(admission, shared), 200);
+    CHECK_EQ(admission.getInFlight(), (size_t)1);
+    shared.disconnect();
+    shared.disconnect();
+    CHECK_EQ(earlier, 1);
+    CHECK_EQ(admission.getInFlight(), (size_t)0);
+    
+    // An upload abandoned mid-stream is still cleaned up next to another callback
+    Request::enableUploads(LittleFS, "/uploads", 4096);
+    int closed = 0;
+    AsyncWebServerRequest upload(HTTP_POST, "/api/v1/files");
+    uint8_t chunk[] = "partial";
+    handleFileUpload(&upload, "log.txt", 0, chunk, sizeof(chunk) - 1, false);
+    Request::onDisconnect(&upload, [&closed]() { closed++; });
+    CHECK_EQ(LittleFS.fileCount(), (size_t)1);
+    upload.disconnect();
+    CHECK_EQ(closed, 1);
+    CHECK_EQ(LittleFS.fileCount(), (size_t)0);
+    Request::disableUploads();
+    
+    return finishTests("test_admission");
+}
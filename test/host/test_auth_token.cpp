@@ -0,0 +1,76 @@
+// AuthToken signing, expiry, and behaviour before and after the clock is set
+#include "HostTest.h"
+#include <Http/AuthToken.h>
+#include <HostClock.h>
+
+static const time_t BOOT_TIME = 42;             // time() right after boot, before NTP
+static const time_t SYNCED_TIME = 1767225600;   // 2026-01-01
+
+static bool valid(const String& token) {
+    TokenClaims claims;
+    return AuthToken::verify(token, claims);
+}
+
+int main() {
+    AuthToken::setSecret("test-secret");
+    TokenClaims claims;
+    
+    // Before the clock is set, tokens expire against the uptime and are bound to this boot
+    hostWallClock = BOOT_TIME;
+    CHECK(!AuthToken::isClockSet());
+    String bootToken = AuthToken::issue(7, "admin", 3600);
+    CHECK(bootToken.length() > 0);
+    CHECK(AuthToken::verify(bootToken, claims));
+    CHECK_EQ(claims.userId, 7u);
+    CHECK(claims.role == "admin");
+    CHECK(claims.bootBound);
+    CHECK(claims.expiresAt < 86400);
+    
+    // Setting the clock later does not expire them
+    hostWallClock = SYNCED_TIME;
+    CHECK(AuthToken::isClockSet());
+    CHECK(valid(bootToken));
+    
+    // Once set, tokens carry a Unix expiry
+    String wallToken = AuthToken::issue(3, "user", 3600);
+    CHECK(AuthToken::verify(wallToken, claims));
+    CHECK(!claims.bootBound);
+    CHECK_EQ(claims.expiresAt, (uint32_t)SYNCED_TIME + 3600);
+    hostWallClock = SYNCED_TIME + 3600;
+    CHECK(!valid(wallToken));
+    
+    // After a reboot, before the clock is set again, a Unix expiry cannot be trusted
+    hostWallClock = BOOT_TIME;
+    CHECK(!valid(wallToken));
+    hostWallClock = SYNCED_TIME + 60;
+    CHECK(valid(wallToken));
+    
+    // Boot-bound tokens end with their uptime expiry
+    hostUptimeAdvance = 3601LL * 1000000;
+    CHECK(!valid(bootToken));
+    hostUptimeAdvance = 0;
+    
+    // Tampering with any field or the signature is caught
+    String forged = wallToken;
+    forged.replace(".user.", ".admin.");
+    CHECK(!valid(forged));
+    int expiryDot = wallToken.indexOf('.', 2);
+    String extended = wallToken.substring(0, expiryDot + 1) + String((uint32_t)SYNCED_TIME + 999999) +
+                      wallToken.substring(wallToken.lastIndexOf('.'));
+    CHECK(!valid(extended));
+    String truncated = wallToken.substring(0, wallToken.length() - 1) + (wallToken.endsWith("A") ? "B" : "A");
+    CHECK(!valid(truncated));
+    
+    // A different secret rejects everything
+    AuthToken::setSecret("other-secret");
+    CHECK(!valid(wallToken));
+    CHECK(!valid(bootToken));
+    
+    // Roles are restricted to a safe character set
+    AuthToken::setSecret("test-secret");
+    CHECK(AuthToken::issue(1, "a.b").length() == 0);
+    CHECK(AuthToken::issue(1, "").length() == 0);
+    
+    hostWallClock = 0;
+    return finishTests("test_auth_token");
+}
@@ -0,0 +1,102 @@
+// Request coalescing: joined requests share one handler run, and a shared owned payload
+// (a camera frame) is released as soon as the last response sending it is done
+#include "HostTest.h"
+#include <Routing/Router.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+
+static const uint8_t FRAME[] = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0xFF, 0xD9};
+static int captures = 0;
+static int releases = 0;
+static int snapshots = 0;
+static int commands = 0;
+
+static AsyncWebServerRequest* dispatch(Router& router, const String& url, WebRequestMethodComposite method = HTTP_GET) {
+    AsyncWebServerRequest* request = new AsyncWebServerRequest(method, url);
+    router.handleRequest(request);
+    return request;
+}
+
+// The server drains the response and then frees the request along with it
+static std::string finish(AsyncWebServerRequest* request) {
+    std::string body = request->sent ? request->sent->drain() : "";
+    delete request;
+    return body;
+}
+
+int main() {
+    AsyncWebServer server(80);
+    Router router(&server);
+    router.get("/camera", [](Request& request) {
+        captures++;
+        return Response(request.getServerRequest()).binary(FRAME, sizeof(FRAME), "image/jpeg", [] { releases++; });
+    }).coalesce(60000);
+    router.get("/stats", [](Request& request) {
+        return Response(request.getServerRequest()).json(String("{\"uptime\":") + String(captures) + "}");
+    }).coalesce(60000);
+    // Not owned: the pointer may change before a later request would send it
+    router.get("/snapshot", [](Request& request) {
+        snapshots++;
+        return Response(request.getServerRequest()).binary(FRAME, sizeof(FRAME), "image/jpeg");
+    }).coalesce(60000);
+    // Requests with a body are never shared, whatever the route asks for
+    router.post("/command", [](Request& request) {
+        commands++;
+        return Response(request.getServerRequest()).json(String("{}"));
+    }).coalesce(60000);
+    router.match(METHOD_GET | METHOD_POST, "/servo", [](Request& request) {
+        commands++;
+        return Response(request.getServerRequest()).json(String("{}"));
+    }).coalesce(60000);
+    router.init();
+    
+    // A request arriving while the frame is still being sent joins the run
+    AsyncWebServerRequest* first = dispatch(router, "/camera");
+    AsyncWebServerRequest* joined = dispatch(router, "/camera");
+    CHECK_EQ(captures, 1);
+    CHECK_EQ(router.getCoalescedRequests(), 1u);
+    std::string frame((const char*)FRAME, sizeof(FRAME));
+    CHECK(finish(first) == frame);
+    CHECK_EQ(releases, 0);
+    CHECK(finish(joined) == frame);
+    CHECK_EQ(releases, 1);
+    
+    // Once the frame is back with the driver the stored result no longer applies
+    AsyncWebServerRequest* later = dispatch(router, "/camera");
+    CHECK_EQ(captures, 2);
+    CHECK(finish(later) == frame);
+    CHECK_EQ(releases, 2);
+    
+    // Buffered bodies stay shareable for the whole window
+    std::string stats = finish(dispatch(router, "/stats"));
+    CHECK(finish(dispatch(router, "/stats")) == stats);
+    CHECK_EQ(router.getCoalescedRequests(), 2u);
+    
+    // Raw binaries and bodies run the handler every time
+    AsyncWebServerRequest* snapshot = dispatch(router, "/snapshot");
+    CHECK(finish(dispatch(router, "/snapshot")) == frame);
+    CHECK(finish(snapshot) == frame);
+    CHECK_EQ(snapshots, 2);
+    finish(dispatch(router, "/command", HTTP_POST));
+    finish(dispatch(router, "/command", HTTP_POST));
+    finish(dispatch(router, "/servo", HTTP_POST));
+    finish(dispatch(router, "/servo", HTTP_POST));
+    CHECK_EQ(commands, 4);
+    finish(dispatch(router, "/servo"));
+    finish(dispatch(router, "/servo"));
+    CHECK_EQ(commands, 5);
+    CHECK_EQ(router.getCoalescedRequests(), 3u);
+    
+    // Rebuilding the routes drops stored results, which point at the old route entries
+    AsyncWebServerRequest* pending = dispatch(router, "/camera");
+    CHECK_EQ(captures, 3);
+    router.get("/camera/settings", [](Request& request) { return Response(request.getServerRequest()).json(String("{}")); });
+    AsyncWebServerRequest* rebuilt = dispatch(router, "/camera");
+    CHECK_EQ(captures, 4);
+    CHECK_EQ(router.getCoalescedRequests(), 3u);
+    finish(pending);
+    finish(rebuilt);
+    CHECK_EQ(releases, 4);
+    
+    return finishTests("test_coalesce");
+}
@@ -0,0 +1,85 @@
+// Range and If-Range parsing, and how Response::file() answers them
+#include "HostTest.h"
+#include <Http/ByteRange.h>
+#include <Http/Response.h>
+#include <Http/StaticFileCache.h>
+#include <LittleFS.h>
+
+static bool isRange(const ByteRange& range, size_t start, size_t end) {
+    return range.start == start && range.end == end;
+}
+
+static int statusFor(const String& range, const String& ifRange = "") {
+    AsyncWebServerRequest request(HTTP_GET, "/video.bin");
+    request.addHeader("Range", range);
+    if (ifRange.length() > 0) {
+        request.addHeader("If-Range", ifRange);
+    }
+    Response response(&request);
+    response.file("/video.bin");
+    return response.getStatusCode();
+}
+
+int main() {
+    std::vector<ByteRange> ranges;
+    
+    // Closed, open-ended and suffix ranges against a 1000 byte file
+    CHECK_EQ(ByteRangeParser::select("bytes=0-499", 1000, ranges), RANGE_PARTIAL);
+    CHECK(ranges.size() == 1 && isRange(ranges[0], 0, 499));
+    CHECK_EQ(ByteRangeParser::select("bytes=900-", 1000, ranges), RANGE_PARTIAL);
+    CHECK(ranges.size() == 1 && isRange(ranges[0], 900, 999));
+    CHECK_EQ(ByteRangeParser::select("bytes=-100", 1000, ranges), RANGE_PARTIAL);
+    CHECK(ranges.size() == 1 && isRange(ranges[0], 900, 999));
+    CHECK_EQ(ByteRangeParser::select("bytes=-5000", 1000, ranges), RANGE_PARTIAL);
+    CHECK(ranges.size() == 1 && isRange(ranges[0], 0, 999));
+    CHECK_EQ(ByteRangeParser::select("bytes=990-2000", 1000, ranges), RANGE_PARTIAL);
+    CHECK(ranges.size() == 1 && isRange(ranges[0], 990, 999));
+    
+    // Several ranges, with whitespace; unsatisfiable members are dropped
+    CHECK_EQ(ByteRangeParser::select("bytes=0-9, 20-29 ,5000-", 1000, ranges), RANGE_PARTIAL);
+    CHECK(ranges.size() == 2 && isRange(ranges[0], 0, 9) && isRange(ranges[1], 20, 29));
+    
+    // Nothing overlaps the file
+    CHECK_EQ(ByteRangeParser::select("bytes=1000-", 1000, ranges), RANGE_UNSATISFIABLE);
+    CHECK_EQ(ByteRangeParser::select("bytes=2000-3000,1500-", 1000, ranges), RANGE_UNSATISFIABLE);
+    CHECK_EQ(ByteRangeParser::select("bytes=-0", 1000, ranges), RANGE_UNSATISFIABLE);
+    CHECK_EQ(ByteRangeParser::select("bytes=-10", 0, ranges), RANGE_UNSATISFIABLE);
+    CHECK(ranges.empty());
+    
+    // Malformed headers and other units are ignored
+    CHECK_EQ(ByteRangeParser::select("bytes=500-100", 1000, ranges), RANGE_FULL);
+    CHECK_EQ(ByteRangeParser::select("bytes=abc-", 1000, ranges), RANGE_FULL);
+    CHECK_EQ(ByteRangeParser::select("bytes=100", 1000, ranges), RANGE_FULL);
+    CHECK_EQ(ByteRangeParser::select("bytes=-", 1000, ranges), RANGE_FULL);
+    CHECK_EQ(ByteRangeParser::select("items=0-5", 1000, ranges), RANGE_FULL);
+    
+    // Up to RESPONSE_MAX_RANGES ranges are honoured; one more sends the whole file
+    String header = "bytes=";
+    for (int i = 0; i < RESPONSE_MAX_RANGES; i++) {
+        header += String(i * 10) + "-" + String(i * 10 + 4) + ",";
+    }
+    CHECK_EQ(ByteRangeParser::select(header, 1000, ranges), RANGE_PARTIAL);
+    CHECK_EQ(ranges.size(), (size_t)RESPONSE_MAX_RANGES);
+    header += "500-510";
+    CHECK_EQ(ByteRangeParser::select(header, 1000, ranges), RANGE_FULL);
+    CHECK(ranges.empty());
+    
+    // If-Range compares an ETag or an HTTP date, whichever it carries
+    CHECK(ByteRangeParser::ifRangeMatches("\"abc\"", "\"abc\"", "Thu, 01 Jan 2026 00:00:00 GMT"));
+    CHECK(!ByteRangeParser::ifRangeMatches("\"old\"", "\"abc\"", "Thu, 01 Jan 2026 00:00:00 GMT"));
+    CHECK(ByteRangeParser::ifRangeMatches("Thu, 01 Jan 2026 00:00:00 GMT", "\"abc\"", "Thu, 01 Jan 2026 00:00:00 GMT"));
+    CHECK(!ByteRangeParser::ifRangeMatches("Wed, 31 Dec 2025 00:00:00 GMT", "\"abc\"", "Thu, 01 Jan 2026 00:00:00 GMT"));
+    CHECK(!ByteRangeParser::ifRangeMatches("", "\"abc\"", ""));
+    
+    // Through Response::file()
+    LittleFS.put("/video.bin", std::string(1000, 'x'));
+    String etag = StaticFileCache::getInstance()->validatorsFor(LittleFS, "/video.bin")->etag;
+    CHECK_EQ(statusFor("bytes=0-99"), 206);
+    CHECK_EQ(statusFor("bytes=-100"), 206);
+    CHECK_EQ(statusFor("bytes=5000-"), 416);
+    CHECK_EQ(statusFor("bytes=0-99", etag), 206);
+    CHECK_EQ(statusFor("bytes=0-99", "\"stale\""), 200);
+    CHECK_EQ(statusFor("bytes=5000-", "\"stale\""), 200);
+    
+    return finishTests("test_range");
+}
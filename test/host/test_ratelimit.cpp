@@ -0,0 +1,52 @@
+// Token refill when a client retries faster than its bucket gains one milli-token
+#include "HostTest.h"
+#include <HostClock.h>
+#include <Http/Middleware.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+
+static Response allow(Request& request) {
+    return Response(request.getServerRequest()).status(200);
+}
+
+static int statusFor(RateLimitMiddleware& limiter, AsyncWebServerRequest& serverRequest) {
+    Request request(&serverRequest);
+    std::function<Response(Request&)> handler = allow;
+    Middleware* pipeline[] = {&limiter};
+    MiddlewareChain chain(pipeline, 1, handler);
+    return chain(request).getStatusCode();
+}
+
+static void advance(unsigned long ms) {
+    hostUptimeAdvance += (int64_t)ms * 1000;
+}
+
+int main() {
+    AsyncWebServerRequest serverRequest(HTTP_GET, "/api/v1/servos");
+    serverRequest.setRemoteIP(IPAddress(192, 168, 1, 20));
+    
+    // One request a minute gains 1/60 milli-token per ms; retries every 50 ms still earn the next one
+    RateLimitMiddleware slow(1, 60000);
+    CHECK_EQ(statusFor(slow, serverRequest), 200);
+    CHECK_EQ(statusFor(slow, serverRequest), 429);
+    int retries = 0;
+    while (retries < 2000 && statusFor(slow, serverRequest) == 429) {
+        advance(50);
+        retries++;
+    }
+    CHECK(retries >= 1190 && retries <= 1200);
+    
+    // Rounding never credits more than the configured rate: 10 per second, probed every 7 ms
+    RateLimitMiddleware fast(10, 1000);
+    for (int i = 0; i < 10; i++) {
+        CHECK_EQ(statusFor(fast, serverRequest), 200);
+    }
+    int allowed = 0;
+    for (int elapsed = 0; elapsed < 1000; elapsed += 7) {
+        advance(7);
+        if (statusFor(fast, serverRequest) == 200) allowed++;
+    }
+    CHECK(allowed >= 9 && allowed <= 11);
+    
+    return finishTests("test_ratelimit");
+}
@@ -0,0 +1,50 @@
+// Method registration: match(), any(), head() and options()
+#include "HostTest.h"
+#include <Routing/Router.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+
+static Response emptyHandler(Request&) {
+    return Response(nullptr);
+}
+
+int main() {
+    AsyncWebServer server(80);
+    Router router(&server);
+    router.match(METHOD_GET | METHOD_POST, "/search", emptyHandler);
+    router.any("/echo", emptyHandler);
+    router.head("/status", emptyHandler);
+    router.options("/status", emptyHandler);
+    router.init();
+    
+    String search = "/search";
+    String echo = "/echo";
+    String status = "/status";
+    RouteMatch match;
+    
+    // match() registers one route shared by every method in the mask
+    const Route* searchGet = router.resolveRoute(METHOD_GET, search, match);
+    const Route* searchPost = router.resolveRoute(METHOD_POST, search, match);
+    CHECK(searchGet != nullptr);
+    CHECK(searchGet == searchPost);
+    CHECK_EQ(searchGet ? searchGet->methods : 0, METHOD_GET | METHOD_POST);
+    CHECK(router.resolveRoute(METHOD_PUT, search, match) == nullptr);
+    
+    // any() covers the five body and read methods, not HEAD or OPTIONS
+    const Route* echoGet = router.resolveRoute(METHOD_GET, echo, match);
+    CHECK(echoGet != nullptr);
+    CHECK(router.resolveRoute(METHOD_POST, echo, match) == echoGet);
+    CHECK(router.resolveRoute(METHOD_PUT, echo, match) == echoGet);
+    CHECK(router.resolveRoute(METHOD_PATCH, echo, match) == echoGet);
+    CHECK(router.resolveRoute(METHOD_DELETE, echo, match) == echoGet);
+    CHECK(router.resolveRoute(METHOD_HEAD, echo, match) == nullptr);
+    CHECK(router.resolveRoute(METHOD_OPTIONS, echo, match) == nullptr);
+    
+    const Route* statusHead = router.resolveRoute(METHOD_HEAD, status, match);
+    const Route* statusOptions = router.resolveRoute(METHOD_OPTIONS, status, match);
+    CHECK(statusHead != nullptr && statusHead->methods == METHOD_HEAD);
+    CHECK(statusOptions != nullptr && statusOptions->methods == METHOD_OPTIONS);
+    CHECK(router.resolveRoute(METHOD_GET, status, match) == nullptr);
+    
+    return finishTests("test_router");
+}
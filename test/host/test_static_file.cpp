@@ -0,0 +1,75 @@
+// Response::file(): .gz sidecar selection and how often it reaches the filesystem
+#include "HostTest.h"
+#include <Http/Response.h>
+#include <Http/StaticFileCache.h>
+#include <LittleFS.h>
+
+static Response serve(const String& path, bool gzip) {
+    AsyncWebServerRequest request(HTTP_GET, path);
+    if (gzip) {
+        request.addHeader("Accept-Encoding", "gzip, deflate");
+    }
+    Response response(&request);
+    response.file(path);
+    return response;
+}
+
+static bool isGzip(const Response& response) {
+    const String* encoding = response.getHeader("Content-Encoding");
+    return encoding && *encoding == "gzip";
+}
+
+int main() {
+    StaticFileCache* cache = StaticFileCache::getInstance();
+    LittleFS.put("/app.js", "console.log('plain');");
+    LittleFS.put("/app.js.gz", "gzipped bytes");
+    LittleFS.put("/only.css.gz", "gzipped css");
+    LittleFS.put("/plain.txt", "no sidecar");
+    
+    // Representation selection
+    CHECK(isGzip(serve("/app.js", true)));
+    CHECK(!isGzip(serve("/app.js", false)));
+    CHECK(serve("/app.js", false).getHeader("Vary") != nullptr);
+    CHECK(isGzip(serve("/only.css", false)));
+    CHECK(!isGzip(serve("/plain.txt", true)));
+    CHECK(serve("/plain.txt", true).getHeader("Vary") == nullptr);
+    CHECK_EQ(serve("/missing.txt", true).getStatusCode(), 404);
+    
+    // Fresh variants and validators answer without touching storage
+    LittleFS.existsCalls = 0;
+    for (int i = 0; i < 10; i++) {
+        serve("/app.js", true);
+        serve("/app.js", false);
+        serve("/plain.txt", true);
+    }
+    CHECK_EQ(LittleFS.existsCalls, 0ul);
+    
+    // Once the interval lapses a new sidecar is picked up
+    LittleFS.put("/plain.txt.gz", "gzipped text");
+    CHECK(!isGzip(serve("/plain.txt", true)));
+    cache->setRevalidateInterval(0);
+    CHECK(isGzip(serve("/plain.txt", true)));
+    
+    // invalidate() forgets the variants immediately, from either path
+    cache->setRevalidateInterval(60000);
+    LittleFS.remove("/plain.txt.gz");
+    cache->invalidate("/plain.txt.gz");
+    CHECK(!isGzip(serve("/plain.txt", true)));
+    
+    // A same-size rewrite changes the ETag on the next revalidation, with or without modification times
+    cache->setRevalidateInterval(0);
+    LittleFS.clock = 0;
+    LittleFS.put("/config.json", "{\"mode\":1}");
+    String before = cache->validatorsFor(LittleFS, "/config.json")->etag;
+    LittleFS.put("/config.json", "{\"mode\":2}");
+    CHECK(cache->validatorsFor(LittleFS, "/config.json")->etag != before);
+    
+    LittleFS.clock = 1767225600;
+    LittleFS.put("/state.json", "{\"mode\":1}");
+    before = cache->validatorsFor(LittleFS, "/state.json")->etag;
+    LittleFS.clock++;
+    LittleFS.put("/state.json", "{\"mode\":2}");
+    CHECK(cache->validatorsFor(LittleFS, "/state.json")->etag != before);
+    
+    return finishTests("test_static_file");
+}
@@ -0,0 +1,119 @@
+// Multipart uploads: multi-megabyte parts streamed in chunks, moved into place only on a 2xx
+// response, and cleaned up when the request is rejected, oversized or abandoned
+#include "HostTest.h"
+#include <Routing/Router.h>
+#include <Http/Request.h>
+#include <Http/Response.h>
+#include <LittleFS.h>
+#include <string>
+
+void handleFileUpload(AsyncWebServerRequest* request, const String& filename, size_t index, uint8_t* data, size_t len, bool final);
+
+static const size_t SEGMENT = 1460;
+static const size_t MAX_UPLOAD = 4 * 1024 * 1024;
+
+static std::string pattern(size_t size, uint8_t seed) {
+    std::string content(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        content[i] = (char)((i * 31 + i / SEGMENT + seed) & 0xFF);
+    }
+    return content;
+}
+
+static std::string readFile(const String& path) {
+    File file = LittleFS.open(path, FILE_READ);
+    std::string content;
+    uint8_t buffer[SEGMENT];
+    size_t count;
+    while (file && (count = file.read(buffer, sizeof(buffer))) > 0) {
+        content.append((const char*)buffer, count);
+    }
+    return content;
+}
+
+// Feeds one file part the way the server's multipart parser does, a TCP segment at a time;
+// stops without the final chunk after limit bytes to model a dropped connection
+static void feedPart(AsyncWebServerRequest& request, const String& field, const String& filename,
+                     const std::string& content, size_t limit = SIZE_MAX) {
+    request.addParam(field, filename, true, true);
+    size_t end = std::min(limit, content.size());
+    for (size_t index = 0; index < end; index += SEGMENT) {
+        size_t len = std::min(SEGMENT, end - index);
+        bool final = limit >= content.size() && index + len == content.size();
+        handleFileUpload(&request, filename, index, (uint8_t*)content.data() + index, len, final);
+    }
+}
+
+static String seenPath;
+static std::string seenDestination;
+
+int main() {
+    AsyncWebServer server(80);
+    Router router(&server);
+    router.post("/api/v1/files", [](Request& request) {
+        const UploadedFile* firmware = request.file("firmware");
+        if (!firmware || !firmware->complete) {
+            return Response(request.getServerRequest()).status(400).text("firmware required");
+        }
+        seenPath = firmware->path;
+        seenDestination = readFile(firmware->destination);
+        return Response(request.getServerRequest()).status(201).text("stored");
+    });
+    router.post("/api/v1/locked", [](Request& request) {
+        return Response(request.getServerRequest()).status(403).text("read-only");
+    });
+    router.init();
+    Request::enableUploads(LittleFS, "/uploads", MAX_UPLOAD);
+    
+    LittleFS.put("/uploads/firmware.bin", "previous firmware");
+    size_t existing = LittleFS.fileCount();
+    
+    // Accepted: the handler still sees the old destination, the new bytes replace it afterwards
+    std::string firmware = pattern(3 * 1024 * 1024 + 17, 1);
+    std::string notes = pattern(2000, 2);
+    AsyncWebServerRequest accepted(HTTP_POST, "/api/v1/files");
+    feedPart(accepted, "firmware", "firmware.bin", firmware);
+    feedPart(accepted, "notes", "../notes.txt", notes);
+    CHECK_EQ(readFile("/uploads/firmware.bin"), std::string("previous firmware"));
+    router.handleRequest(&accepted);
+    CHECK_EQ(accepted.sent->code, 201);
+    CHECK(seenPath != "/uploads/firmware.bin");
+    CHECK_EQ(seenDestination, std::string("previous firmware"));
+    CHECK(!LittleFS.exists(seenPath));
+    CHECK(readFile("/uploads/firmware.bin") == firmware);
+    CHECK(readFile("/uploads/notes.txt") == notes);
+    CHECK_EQ(LittleFS.fileCount(), existing + 1);
+    accepted.disconnect();
+    CHECK_EQ(LittleFS.fileCount(), existing + 1);
+    existing = LittleFS.fileCount();
+    
+    // Rejected by the handler: the stored copy is untouched and the new part is deleted
+    AsyncWebServerRequest rejected(HTTP_POST, "/api/v1/locked");
+    feedPart(rejected, "firmware", "firmware.bin", pattern(1024 * 1024, 3));
+    router.handleRequest(&rejected);
+    CHECK_EQ(rejected.sent->code, 403);
+    CHECK(readFile("/uploads/firmware.bin") == firmware);
+    CHECK_EQ(LittleFS.fileCount(), existing);
+    rejected.disconnect();
+    
+    // Over maxUploadSize: answered with 413 before the handler runs, nothing left behind
+    AsyncWebServerRequest oversized(HTTP_POST, "/api/v1/files");
+    feedPart(oversized, "firmware", "firmware.bin", pattern(MAX_UPLOAD + SEGMENT, 4));
+    CHECK_EQ(LittleFS.fileCount(), existing);
+    router.handleRequest(&oversized);
+    CHECK_EQ(oversized.sent->code, 413);
+    CHECK(readFile("/uploads/firmware.bin") == firmware);
+    oversized.disconnect();
+    CHECK_EQ(LittleFS.fileCount(), existing);
+    
+    // Aborted mid-stream: the partial part is removed when the connection drops
+    AsyncWebServerRequest aborted(HTTP_POST, "/api/v1/files");
+    feedPart(aborted, "firmware", "firmware.bin", pattern(2 * 1024 * 1024, 5), 1024 * 1024);
+    CHECK_EQ(LittleFS.fileCount(), existing + 1);
+    aborted.disconnect();
+    CHECK_EQ(LittleFS.fileCount(), existing);
+    CHECK(readFile("/uploads/firmware.bin") == firmware);
+    
+    Request::disableUploads();
+    return finishTests("test_upload");
+}